@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "./memPool/mempool.h"
+
+#define BENCH_SECTORS                   1024
+#define BENCH_SECT_SIZE                 256
+#define BENCH_RECORD                    16
+#define BENCH_BLOCK                     100             // Sectors per measured block of the chain
+#define BENCH_ROUNDS                    20
+
+// MEM_POOL_DECLARE(Name_Of_Variable, Sector_Count, Buffer_Size_Of_Sector);
+MEM_POOL_DECLARE(bench, BENCH_SECTORS, BENCH_SECT_SIZE);
+
+void *pMemory = NULL;
+char benchRecord[BENCH_RECORD];
+
+static double benchNow(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((double)now.tv_sec * 1e9) + (double)now.tv_nsec;
+}
+
+void benchAppend(void)
+{
+    void *p_chain = NULL;
+    unsigned long round = 0;
+    unsigned long block = 0;
+    unsigned long index = 0;
+    unsigned long appends = (BENCH_BLOCK * BENCH_SECT_SIZE) / BENCH_RECORD;
+    double start = 0;
+    double elapsed[(BENCH_SECTORS / BENCH_BLOCK)];
+
+    memset(elapsed, 0, sizeof(elapsed));
+    for(round = 0; round < BENCH_ROUNDS; round++)
+    {
+        p_chain = mempool_alloc(pMemory);
+        for(block = 0; block < (BENCH_SECTORS / BENCH_BLOCK); block++)
+        {
+            start = benchNow();
+            for(index = 0; index < appends; index++)
+            {
+                mempool_writeToIndex(pMemory, p_chain, benchRecord, BENCH_RECORD);
+            }
+            elapsed[block] += benchNow() - start;
+        }
+        mempool_free(p_chain);
+    }
+
+    printf("Append of %d bytes, ns per call by chain length\r\n", BENCH_RECORD);
+    for(block = 0; block < (BENCH_SECTORS / BENCH_BLOCK); block++)
+    {
+        printf("  sectors %4lu - %4lu: %8.1f\r\n", block * BENCH_BLOCK, (block + 1) * BENCH_BLOCK,\
+                    elapsed[block] / (double)(appends * BENCH_ROUNDS));
+    }
+}
+
+void benchRead(void)
+{
+    void *p_chain = NULL;
+    unsigned long round = 0;
+    unsigned long block = 0;
+    unsigned long index = 0;
+    unsigned long reads = (BENCH_BLOCK * BENCH_SECT_SIZE) / BENCH_RECORD;
+    double start = 0;
+    double elapsed[(BENCH_SECTORS / BENCH_BLOCK)];
+    char target[BENCH_RECORD];
+
+    memset(elapsed, 0, sizeof(elapsed));
+    for(round = 0; round < BENCH_ROUNDS; round++)
+    {
+        p_chain = mempool_alloc(pMemory);
+        for(index = 0; index < ((BENCH_SECTORS / BENCH_BLOCK) * reads); index++)
+        {
+            mempool_writeToIndex(pMemory, p_chain, benchRecord, BENCH_RECORD);
+        }
+        for(block = 0; block < (BENCH_SECTORS / BENCH_BLOCK); block++)
+        {
+            start = benchNow();
+            for(index = 0; index < reads; index++)
+            {
+                mempool_readFromIndex(p_chain, target, sizeof(target), BENCH_RECORD);
+            }
+            elapsed[block] += benchNow() - start;
+        }
+        mempool_free(p_chain);
+    }
+
+    printf("Read of %d bytes, ns per call by read position\r\n", BENCH_RECORD);
+    for(block = 0; block < (BENCH_SECTORS / BENCH_BLOCK); block++)
+    {
+        printf("  sectors %4lu - %4lu: %8.1f\r\n", block * BENCH_BLOCK, (block + 1) * BENCH_BLOCK,\
+                    elapsed[block] / (double)(reads * BENCH_ROUNDS));
+    }
+}
+
+void benchBulk(void)
+{
+    void *p_sect[256];
+    unsigned long round = 0;
+    unsigned long index = 0;
+    double start = 0;
+    double single = 0;
+    double bulk = 0;
+
+    for(round = 0; round < (BENCH_ROUNDS * 100); round++)
+    {
+        start = benchNow();
+        for(index = 0; index < 256; index++)
+        {
+            p_sect[index] = mempool_alloc(pMemory);
+        }
+        for(index = 0; index < 256; index++)
+        {
+            mempool_free(p_sect[index]);
+        }
+        single += benchNow() - start;
+
+        start = benchNow();
+        mempool_allocBulk(pMemory, p_sect, 256);
+        mempool_freeBulk(p_sect, 256);
+        bulk += benchNow() - start;
+    }
+
+    printf("Batch of 256 sectors alloc and free, ns per sector\r\n");
+    printf("  one by one: %8.1f\r\n", single / (double)(256 * BENCH_ROUNDS * 100));
+    printf("  bulk      : %8.1f\r\n", bulk / (double)(256 * BENCH_ROUNDS * 100));
+}
+
+int main(void)
+{
+    pMemory = mempool_init(MEM_POOL_ADDR(bench), MEM_POOL_SIZE(bench), MEM_POOL_SECT_CNT(bench), MEM_POOL_SECT_SIZE(bench));
+    memset(benchRecord, 'x', sizeof(benchRecord));
+    benchAppend();
+    benchRead();
+    benchBulk();
+    return 0;
+}
+
+/* End of Code */
+
+/* 
+ * Build syntax
+ * 
+ * gcc -O2 -I./memPool memPool/mempool.c benchMemPool.c -o benchMemPool
+ * 
+ * */
@@ -23,521 +23,3681 @@
  *************************************************************************************** */
 
 #include "mempool.h"
+#include <limits.h>
 #include <string.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(MEM_POOL_POSIX)
+#include <fcntl.h>
+#include <sched.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__linux__)
+#define MEM_POOL_FUTEX                  1
+#include <linux/futex.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#endif
+#endif
 
 /* **************************************************************************
  *              Macros / Defines
  ************************************************************************** */
 #define MEM_POOL_OFFSET(st, m)          ((size_t)&(((st *)0)->m))
+#define MEM_POOL_TOP_INDEX(top)         ((unsigned long)((top) & 0xFFFFFFFFuLL))
+#define MEM_POOL_TOP_TAG(top)           ((top) >> 32)
+#define MEM_POOL_TOP(tag, index)        (((unsigned long long)(tag) << 32) | (unsigned long long)(index))
+#define MEM_POOL_LINK_SHIFT             28
+#define MEM_POOL_LINK(slot, index)      (((uint32_t)(slot) << MEM_POOL_LINK_SHIFT) | ((uint32_t)(index) + 1u))
+#define MEM_POOL_LINK_SLOT(link)        ((link) >> MEM_POOL_LINK_SHIFT)
+#define MEM_POOL_LINK_INDEX(link)       (((link) & ((1u << MEM_POOL_LINK_SHIFT) - 1u)) - 1u)
+#define MEM_POOL_DESC(pool)             ((t_MemSect *)((uintptr_t)(pool) + (pool)->Mem_Desc_Start))
+#define MEM_POOL_HEADS(pool)            ((t_MemHead *)((uintptr_t)(pool) + (pool)->Mem_Head_Start))
+#define MEM_POOL_DATA(pool)             ((uintptr_t)(pool) + (pool)->Mem_Start)
+#define MEM_POOL_VARINT_MAX             (((sizeof(unsigned long) * 8u) + 6u) / 7u)
+#define MEM_POOL_SNAP_MAGIC             0x4C4F504DuL    // "MPOL" in a little endian file
+#define MEM_POOL_SNAP_VERSION           1uL
+#define MEM_POOL_WAIT_FREE              0x00000001u     // Wait_Mask, one thread in mempool_allocWait
+#define MEM_POOL_WAIT_FREE_ALL          0x00003FFFu
+#define MEM_POOL_WAIT_DATA              0x00004000u     // Wait_Mask, one thread in mempool_streamWait
+#define MEM_POOL_WAIT_DATA_ALL          0x0FFFC000u
+#define MEM_POOL_WAIT_USED              0x10000000u     // Wait_Mask, set by the first wait or eventfd, nothing is notified before
+#define MEM_POOL_ARMED_FREE             0x40000000u     // Wait_Mask, MEM_POOL_EVENT_FREE armed on Event_Fd
+#define MEM_POOL_ARMED_DATA             0x80000000u     // Wait_Mask, MEM_POOL_EVENT_DATA armed on Event_Fd
+
+/* **************************************************************************
+ *              Local Structures
+ ************************************************************************** */
+typedef struct s_MemRun {   /* Sectors collected for one free list push */
+    struct s_Mem        *pPool;                         // Pool the sectors go back to
+    t_MemSect           *pFirst;                        // First collected sector
+    t_MemSect           *pLast;                         // Last collected sector
+    unsigned long       Count;                          // Number of collected sectors
+} t_MemRun;
+
+typedef struct s_MemSnap {  /* Snapshot Trailer, after the pool image */
+    uint32_t            Magic;                          // MEM_POOL_SNAP_MAGIC
+    uint32_t            Version;                        // MEM_POOL_SNAP_VERSION
+    uint32_t            Align;                          // MEM_POOL_ALIGN of the build writing it
+    uint32_t            Ctx_Size;                       // Sizes of header, descriptor and chain state, 10 bits each
+    uint64_t            Pool_Size;                      // Bytes of the pool image
+    uint64_t            Meta_Size;                      // Bytes covered by the checksum, header to first sector buffer
+    uint64_t            Checksum;                       // Checksum of the metadata
+} t_MemSnap;
 
 /* **************************************************************************
  *              Static Constants
  ************************************************************************** */
 static const unsigned long memCtxSize = sizeof(t_Mem);
 static const unsigned long memSectorCtxSize = sizeof(t_MemSect);
+static const unsigned long memHeadCtxSize = sizeof(t_MemHead);
+
+/* **************************************************************************
+ *              Static Function Proto-types
+ ************************************************************************** */
+static void mempool_sectPrepare(struct s_Mem *pPool, const unsigned long From, const unsigned long To);
+static void mempool_chainRelease(t_MemSect *pFirst, const t_MemSect *pStop);
+static unsigned long mempool_writeChain(const void *const pMem, const t_MemGroup *const pGroup, const void *const pMemSect,\
+                                            const char *const pSource, const unsigned long SrcSize);
 
 /* **************************************************************************
  *              Function Definitions
  ************************************************************************** */
 
 /* **************************************************************************
- * Function initializes the memory section for future use
- *  pMem        ->  Pointer to the memory fetched using MEM_POOL_ADDR(Name) macro
- *  Size        ->  Size of memory fetched using MEM_POOL_SIZE(Name) macro
- *  SectCnt     ->  Number of Sectors of memory blocks fetched using MEM_POOL_CNT(Name) macro
- *  SectSize    ->  Size of memory sector fetched using MEM_POOL_SECT_SIZE(Name) macro
- * Returns the start address of the current initialized Heap.
+ * Function finds the pool owning a sector, descriptors sit right after the
+ * memory header so the pool is found without a load from memory elsewhere
+ *  pSect       ->  Pointer to sector descriptor
+ * Returns the memory header.
  ************************************************************************** */
-void *mempool_init(const void *const pMem, const unsigned long Size, const unsigned long SectCnt, const unsigned long SectSize)
+static struct s_Mem *mempool_sectPool(const t_MemSect *pSect)
 {
-    void *p_mem = (void *)pMem;
-    unsigned long sector = SectSize;
-    unsigned long index = 0;
+    return (struct s_Mem *)((uintptr_t)(pSect - pSect->Self) - MEM_POOL_ROUND(memCtxSize));
+}
 
-    // Number of sectors of memory
-    ((struct s_Mem *)p_mem)->Sec_Cnt = (unsigned long)SectCnt;
-    // Size of each sector
-    ((struct s_Mem *)p_mem)->Sec_Size = (unsigned long)SectSize;
-    // Start of memory sector descriptors
-    ((struct s_Mem *)p_mem)->Mem_Desc_Start = (unsigned long)(((char *)p_mem) + memCtxSize);
-    // Start of usable memory sectors
-    ((struct s_Mem *)p_mem)->Mem_Start = (unsigned long)(((char *)p_mem) + memCtxSize) + (SectCnt * memSectorCtxSize);
-    // Number of used sectors of usable memory
-    ((struct s_Mem *)p_mem)->Total_Memory = (unsigned long)Size;
+/* **************************************************************************
+ * Function gives the chain state kept for a sector while it heads a chain
+ *  pSect       ->  Pointer to sector descriptor
+ * Returns pointer to the chain state.
+ ************************************************************************** */
+static t_MemHead *mempool_sectHead(const t_MemSect *pSect)
+{
+    return &MEM_POOL_HEADS(mempool_sectPool(pSect))[pSect->Self];
+}
 
-    p_mem = (void *)(*((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_Mem, Mem_Desc_Start))));
+/* **************************************************************************
+ * Function resolves a link kept by a sector, slot 0 links stay in the pool of
+ * that sector, slot n goes to peer n of the pool
+ *  pFrom       ->  Pointer to sector descriptor holding the link
+ *  Link        ->  Link to be resolved
+ * Returns the linked Sector Pointer, NULL for an empty link
+ ************************************************************************** */
+static t_MemSect *mempool_linkSect(const t_MemSect *pFrom, const uint32_t Link)
+{
+    const t_MemSect *p_desc = pFrom - pFrom->Self;
 
-    for(index = 0; index < SectCnt; index++)
+    if(Link == 0u)
     {
-        // Preparing sector headers
-        // Resetting all the flags from all the sectors
-        *((unsigned long *)(((unsigned long)((char *)p_mem)) + (memSectorCtxSize * index) + MEM_POOL_OFFSET(t_MemSect, Flags))) = MEMSECT_FLAGS_NONE;
-        // Next sector start address is copied
-        *((unsigned long *)(((unsigned long)((char *)p_mem)) + (memSectorCtxSize * index) + MEM_POOL_OFFSET(t_MemSect, pNext))) = ( (((sector * (index * 1)) + memCtxSize + (memSectorCtxSize * SectCnt)) >= Size) ?\
-                                                                                                                                    ((unsigned long)(((char *)p_mem))) :\
-                                                                                                                                    ((unsigned long)(((char *)p_mem) + (memSectorCtxSize * (index + 1)))) );
-        // The buffer concatenated with NULL buffer
-        *((unsigned long *)(((unsigned long)((char *)p_mem)) + (memSectorCtxSize * index) + MEM_POOL_OFFSET(t_MemSect, pConcat))) = 0uL;
-        // Usable memory start address for current sector
-        *((unsigned long *)(((unsigned long)((char *)p_mem)) + (memSectorCtxSize * index) + MEM_POOL_OFFSET(t_MemSect, pMemSect))) = (((unsigned long)((char *)p_mem)) + ((sector * index) + (memSectorCtxSize * SectCnt)));
-        // Resetting the read index to 0
-        *((unsigned long *)(((unsigned long)((char *)p_mem)) + (memSectorCtxSize * index) + MEM_POOL_OFFSET(t_MemSect, ReadIndex))) = 0uL;
-        // Resetting the write index to 0
-        *((unsigned long *)(((unsigned long)((char *)p_mem)) + (memSectorCtxSize * index) + MEM_POOL_OFFSET(t_MemSect, WriteIndex))) = 0uL;
+        return NULL;
+    }
+    if(MEM_POOL_LINK_SLOT(Link) != 0u)
+    {
+        p_desc = MEM_POOL_DESC(__atomic_load_n(&mempool_sectPool(pFrom)->pPeer[MEM_POOL_LINK_SLOT(Link) - 1u], __ATOMIC_ACQUIRE));
     }
 
-    (void)sector;
-    (void)index;
-    return (void *)pMem;
+    return (t_MemSect *)&p_desc[MEM_POOL_LINK_INDEX(Link)];
 }
 
 /* **************************************************************************
- * Function allocates the unallocated memory sector for the user
- *  pMem        ->  Pointer to the top of Heap memory fetched using MEM_POOL_ADDR(Name) macro
- * Returns the Sector Pointer if available else returns NULL
+ * Function gives the sector concatenated after the given one, or the next
+ * free sector while it is unallocated
+ *  pSect       ->  Pointer to sector descriptor
+ * Returns the next Sector Pointer, NULL at the end
  ************************************************************************** */
-void *mempool_alloc(const void *const pMem)
+static t_MemSect *mempool_sectNext(const t_MemSect *pSect)
 {
-    unsigned long index = 0;
-    unsigned long sect_cnt = ((struct s_Mem *)pMem)->Sec_Cnt;
-    void *mem_zero = (void *)((struct s_Mem *)pMem)->Mem_Desc_Start;
-    void *mem_ptr = NULL;
-
-    for(index = 0; index < sect_cnt; index++)
-    {
-        if(*(((unsigned long *)(((char *)mem_zero) + (memSectorCtxSize * index) + MEM_POOL_OFFSET(t_MemSect, Flags)))) == MEMSECT_FLAGS_NONE)
-        {
-            *((unsigned long *)(((char *)mem_zero) + (memSectorCtxSize * index) + MEM_POOL_OFFSET(t_MemSect, Flags))) = MEMSECT_FLAGS_USED;
-            *((unsigned long *)(((char *)mem_zero) + (memSectorCtxSize * index) + MEM_POOL_OFFSET(t_MemSect, pConcat))) = 0uL;
-            *((unsigned long *)(((char *)mem_zero) + (memSectorCtxSize * index) + MEM_POOL_OFFSET(t_MemSect, ReadIndex))) = 0uL;
-            *((unsigned long *)(((char *)mem_zero) + (memSectorCtxSize * index) + MEM_POOL_OFFSET(t_MemSect, WriteIndex))) = 0uL;
-            mem_ptr = (void *)(((unsigned long)((char *)mem_zero)) + (memSectorCtxSize * index));
-            break;
-        }
-    }
-
-    (void)sect_cnt;
-    (void)index;
-    return mem_ptr;
+    return mempool_linkSect(pSect, pSect->Concat);
 }
 
 /* **************************************************************************
- * Function frees the allocated sector
- *  pMemSect    ->  Pointer to memory sector descriptor which needs to be marked
- *                  free for the future use.
- * Returns none.
+ * Function makes the link a sector keeps to another sector, a sector of a pool
+ * not seen before takes the next free peer slot of the pool
+ *  pFrom       ->  Pointer to sector descriptor to hold the link
+ *  pTo         ->  Pointer to sector descriptor to be linked, NULL for none
+ * Returns the link, zero if every peer slot is taken by other pools
  ************************************************************************** */
-void mempool_free(const void *const pMemSect)
+static uint32_t mempool_sectLink(const t_MemSect *pFrom, const t_MemSect *pTo)
 {
-    unsigned long flags;
-    unsigned long sect_buf_size = 0;
-    void *p_mem = (void *)pMemSect;
+    struct s_Mem *p_pool = NULL;
+    struct s_Mem *p_to = NULL;
+    struct s_Mem *p_peer = NULL;
+    uint32_t slot = 0;
 
-    if(p_mem != NULL)
+    if(pTo == NULL)
+    {
+        return 0u;
+    }
+    if((pFrom - pFrom->Self) == (pTo - pTo->Self))
     {
-        flags = MEMSECT_FLAGS_USED;
+        return MEM_POOL_LINK(0u, pTo->Self);
     }
 
-    while(flags != MEMSECT_FLAGS_NONE)
+    p_pool = mempool_sectPool(pFrom);
+    p_to = mempool_sectPool(pTo);
+    if((p_pool->Flags | p_to->Flags) & MEM_POOL_FLAGS_SHARED)
+    {
+        // Peer addresses only hold in one process
+        return 0u;
+    }
+    for(slot = 0; slot < MEM_POOL_PEER_MAX; slot++)
     {
-        flags = *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, Flags)));
-        *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, Flags))) = MEMSECT_FLAGS_NONE;
-        *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, ReadIndex))) = 0uL;
-        *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, WriteIndex))) = 0uL;
-        sect_buf_size = ((unsigned long)(((t_MemSect *)*((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pNext))))->pMemSect)) -\
-                        *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pMemSect)));
-        
-        if(flags & MEMSECT_FLAGS_CONCAT)
+        p_peer = __atomic_load_n(&p_pool->pPeer[slot], __ATOMIC_ACQUIRE);
+        if((p_peer == NULL) && __atomic_compare_exchange_n(&p_pool->pPeer[slot], &p_peer, p_to, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
         {
-            p_mem = (void *)(*((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pConcat))));
+            p_peer = p_to;
         }
-        else
+        if(p_peer == p_to)
         {
-            flags = MEMSECT_FLAGS_NONE;
+            return MEM_POOL_LINK(slot + 1u, pTo->Self);
         }
-        (void)sect_buf_size;
     }
+
+    return 0u;
 }
 
 /* **************************************************************************
- * Function used for reading data from the memory, everytime you read data
- * the read pointer is incremented
- *  pMemSect    ->  Pointer to memory sector descriptor to be read from read index
- *  pTarget     ->  Pointer to target buffer
- *  TargetSize  ->  Size of the target buffer
- *  ReadCount   ->  Number of bytes to be read
- * Returns the number of bytes copied to target buffer, zero if error
+ * Function adds to a pool counter, atomically on a concurrent pool
+ *  pPool       ->  Pointer to the memory header
+ *  pCounter    ->  Pointer to the counter inside the memory header
+ *  Value       ->  Value to be added, wraps around to subtract
+ * Returns none.
  ************************************************************************** */
-unsigned long mempool_readFromIndex(const void *const pMemSect, void *pTarget,\
-                                        const unsigned long TargetSize, const unsigned long ReadCount)
+static void mempool_statAdd(struct s_Mem *pPool, unsigned long *pCounter, const unsigned long Value)
 {
-    void *p_mem = (void *)pMemSect;
-    void *p_read = NULL;
-    void *p_head = p_mem;
-    void *p_out = pTarget;
-    unsigned long bytes_read = 0;
-    unsigned long read_index = 0;
-    unsigned long write_index = 0;
-    unsigned long sect_buf_size = 0;
-    unsigned long flags = 0;
-    unsigned long read_processed = ReadCount;
-    unsigned long read_count = 0;
-
-    if(read_processed > *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, WriteIndex))))
+    if(pPool->Flags & MEM_POOL_FLAGS_CONCURRENT)
     {
-        read_processed = *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, WriteIndex))) -\
-                            *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, ReadIndex)));
+        __atomic_fetch_add(pCounter, Value, __ATOMIC_RELAXED);
     }
-
-    if((p_mem != NULL) && (pTarget != NULL))
+    else
     {
-        // Get Read Pointer
-        flags = *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, Flags)));
-        read_index = *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, ReadIndex)));
-        write_index = *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, WriteIndex)));
-        sect_buf_size = ((unsigned long)(((t_MemSect *)(*((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pNext)))))->pMemSect)) -\
-                        *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pMemSect)));
-        
-        if(read_index >= write_index)
-        {
-            // No data to be read
-            read_processed = 0;
-        }
-        // Walking towards read index concatenated buffer by buffer
-        while((read_index > sect_buf_size) && (read_processed != 0))
-        {
-            if(flags & MEMSECT_FLAGS_CONCAT)
-            {
-                read_index -= sect_buf_size;
-                p_mem = (void *)(*((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pConcat))));
-            }
-            flags = *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, Flags)));
-            sect_buf_size = ((unsigned long)(((t_MemSect *)(*((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pNext)))))->pMemSect)) -\
-                            *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pMemSect)));
-        }
-        // Read data sector by sector
-        while(read_processed > 0)
-        {
-            bytes_read = 0;
-            flags = *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, Flags)));
-            p_read = (void *)(*((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pMemSect))) + read_index);
-            sect_buf_size = ((unsigned long)(((t_MemSect *)(*((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pNext)))))->pMemSect)) -\
-                            *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pMemSect)));
-            
-            if(TargetSize < read_processed)
-            {
-                // Reading partial as not enough space in target buffer
-                bytes_read = TargetSize;
-            }
-            else
-            {
-                // Reading as per read count value
-                bytes_read = read_processed;
-            }
-
-            if(sect_buf_size < bytes_read)
-            {
-                bytes_read = sect_buf_size;
-            }
-
-            if((sect_buf_size - read_index) < bytes_read)
-            {
-                bytes_read = sect_buf_size - read_index;
-            }
-
-            if((read_count + bytes_read) > TargetSize)
-            {
-                // Since target buffer is exhausted
-                break;
-            }
-
-            memcpy(p_out, p_read, bytes_read);
-            *((unsigned long *)(((char *)p_head) + MEM_POOL_OFFSET(t_MemSect, ReadIndex))) += bytes_read;
-            read_processed -= bytes_read;
-            read_count += bytes_read;
-            p_out = (void *)((unsigned long)((char *)p_out + bytes_read));
-
-            if(flags & MEMSECT_FLAGS_CONCAT)
-            {
-                p_mem = (void *)(*((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pConcat))));
-            }
-            else
-            {
-                break;
-            }
-
-            if(read_count >= ReadCount)
-            {
-                break;
-            }
-
-            if(*((unsigned long *)(((char *)p_head) + MEM_POOL_OFFSET(t_MemSect, ReadIndex))) >=\
-                *((unsigned long *)(((char *)p_head) + MEM_POOL_OFFSET(t_MemSect, WriteIndex))))
-            {
-                // Read completed
-                break;
-            }
-
-            read_index = 0;
-        }
+        *pCounter += Value;
     }
-
-    (void)read_index;
-    (void)sect_buf_size;
-    (void)bytes_read;
-    return read_count;
 }
 
 /* **************************************************************************
- * Function reads entire buffer data of data limited to size of Target Buffer
- * read pointer index is not incremented while execution data read from Index 0
- *  pMemSect    ->  Pointer to memory sector descriptor to be read from read index
- *  pTarget     ->  Pointer to target buffer
- *  TargetSize  ->  Size of the target buffer
- * Returns the number of bytes copied to target buffer, zero if error
+ * Function adds to the byte counters on the stripe of the calling thread, so
+ * threads reading and writing their own chains keep off each others lines
+ *  pPool       ->  Pointer to the memory header
+ *  Written     ->  Bytes stored
+ *  Read        ->  Bytes returned
+ * Returns none.
  ************************************************************************** */
-unsigned long mempool_readFull(const void *const pMemSect, void *pTarget, const unsigned long TargetSize)
+static void mempool_statBytes(struct s_Mem *pPool, const unsigned long Written, const unsigned long Read)
 {
-    void *p_mem = (void *)pMemSect;
-    void *p_read = NULL;
-    void *p_out = pTarget;
-    unsigned long bytes_read = 0;
-    unsigned long sect_buf_size = 0;
-    unsigned long flags = 0;
-    unsigned long data_present = 1;
-    unsigned long read_processed = TargetSize;
-    unsigned long read_count = 0;
+    static unsigned int stripe_next = 0;
+    static __thread unsigned int stripe = 0;        // Stripe + 1, 0 until the thread counts
+    t_MemCount *p_count = &pPool->Bytes[0];
 
-    if(read_processed > *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, WriteIndex))))
+    if(pPool->Flags & MEM_POOL_FLAGS_CONCURRENT)
     {
-        read_processed = *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, WriteIndex)));
+        if(stripe == 0u)
+        {
+            stripe = (__atomic_fetch_add(&stripe_next, 1u, __ATOMIC_RELAXED) % MEM_POOL_STAT_STRIPES) + 1u;
+        }
+        p_count = &pPool->Bytes[stripe - 1u];
     }
-
-    if(read_processed == 0)
+    if(Written != 0uL)
     {
-        // No data writted in the memory
-        return 0;
+        mempool_statAdd(pPool, &p_count->Bytes_Written, Written);
     }
-
-    if((p_mem != NULL) && (pTarget != NULL))
+    if(Read != 0uL)
     {
-        while(data_present == 1)
-        {
-            flags = *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, Flags)));
-            p_read = (void *)(*((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pMemSect))));
-            sect_buf_size = ((unsigned long)(((t_MemSect *)(*((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pNext)))))->pMemSect)) -\
-                            *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pMemSect)));
-            
-            if(read_processed < sect_buf_size)
-            {
-                bytes_read = read_processed;
-            }
-            else
-            {
-                bytes_read = sect_buf_size;
-            }
-
-            if((read_count + bytes_read) > TargetSize)
-            {
-                // Since target buffer is exhausted
-                break;
-            }
-
-            memcpy(p_out, p_read, bytes_read);
-            read_processed -= bytes_read;
-            read_count += bytes_read;
-            if(flags & MEMSECT_FLAGS_CONCAT)
-            {
-                p_mem = (void *)(*((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pConcat))));
-            }
-            else
-            {
-                data_present = 0;
-            }
-            if(read_processed == 0)
-            {
-                data_present = 0;
-            }
-            else
-            {
-                p_out = (void *)((unsigned long)((char *)p_out + bytes_read));
-            }
-        }
+        mempool_statAdd(pPool, &p_count->Bytes_Read, Read);
     }
-
-    (void)bytes_read;
-    (void)flags;
-    (void)sect_buf_size;
-    (void)read_processed;
-    return read_count;
 }
 
 /* **************************************************************************
- * Function writes data to allocated buffer or adds data to new buffer allocation
- *  pMem        ->  Pointer to the memory fetched using MEM_POOL_ADDR(Name) macro
- *  pMemSect    ->  Pointer to memory sector descriptor where data is to be written
- *  pSouce      ->  Pointer to source buffer from where data needs to be read
- *  SrcSize     ->  Length of the data to be written
- * Returns number of bytes written to the memory sector.
+ * Function accounts sectors taken off the free list and keeps the high water
+ * mark of used sectors
+ *  pPool       ->  Pointer to the memory header
+ *  Count       ->  Number of sectors taken
+ * Returns none.
  ************************************************************************** */
-unsigned long mempool_writeToIndex(const void *const pMem, const void *const pMemSect,\
-                                    const char *const pSource, const unsigned long SrcSize)
+static void mempool_statUsed(struct s_Mem *pPool, const unsigned long Count)
 {
-    void *p_mem = (void *)pMemSect;
-    void *p_head = p_mem;
-    void *p_write = NULL;
-    void *p_next = NULL;
-    void *p_src = (void *)pSource;
-    unsigned long write_index = 0;
-    unsigned long flags = 0;
-    unsigned long sect_buf_size = 0;
-    unsigned long write_processed = SrcSize;
-    unsigned long bytes_to_write = 0;
-    unsigned long write_count = 0;
+    unsigned long used = 0;
+    unsigned long high = 0;
 
-    if((p_mem != NULL) && (pSource != NULL))
+    if(pPool->Flags & MEM_POOL_FLAGS_CONCURRENT)
     {
-        flags = *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, Flags)));
-        write_index = *((unsigned long *)(((char *)p_head) + MEM_POOL_OFFSET(t_MemSect, WriteIndex)));
-        sect_buf_size = ((unsigned long)(((t_MemSect *)(*((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pNext)))))->pMemSect)) -\
-                            *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pMemSect)));
-        
-        while((write_index > sect_buf_size) && (write_processed != 0))
+        used = __atomic_add_fetch(&pPool->Sect_Used, Count, __ATOMIC_RELAXED);
+        high = __atomic_load_n(&pPool->Sect_High, __ATOMIC_RELAXED);
+        while((used > high) && !__atomic_compare_exchange_n(&pPool->Sect_High, &high, used, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
         {
-            if(flags & MEMSECT_FLAGS_CONCAT)
-            {
-                write_index -= sect_buf_size;
-                p_mem = (void *)(*((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pConcat))));
-            }
-            flags = *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, Flags)));
-            sect_buf_size = ((unsigned long)(((t_MemSect *)(*((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pNext)))))->pMemSect)) -\
-                                *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pMemSect)));
         }
-
-        write_count = 0;
-        while(write_processed > 0)
+    }
+    else
+    {
+        pPool->Sect_Used += Count;
+        if(pPool->Sect_Used > pPool->Sect_High)
         {
-            flags = *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, Flags)));
-            p_write = (void *)((*((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pMemSect)))) + write_index);
-            sect_buf_size = ((unsigned long)(((t_MemSect *)(*((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pNext)))))->pMemSect)) -\
-                                *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pMemSect)));
-            
-            if((signed long)(write_processed - (sect_buf_size - write_index)) > 0)
-            {
-                if((((unsigned long)(*((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pConcat))))) == 0uL) &&\
-                    (write_processed > (sect_buf_size - write_index)))
-                {
-                    // New sector allocation needed
-                    p_next = mempool_alloc(pMem);
-                    if(p_next != NULL)
-                    {
-                        // Memory Pool Allocation successful
-                        *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, Flags))) |= MEMSECT_FLAGS_CONCAT;
-                        *((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pConcat))) = (unsigned long)p_next;
-                    }
-                    else
-                    {
-                        // Memory all consumed
-                        break;
-                    }
-                }
-                else
-                {
-                    p_next = (void *)(*((unsigned long *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, pConcat))));
-                }
-
-                if((sect_buf_size - write_index) > write_processed)
-                {
-                    bytes_to_write = write_processed;
-                }
-                else
-                {
-                    bytes_to_write = sect_buf_size - write_index;
-                }
-            }
-            else
-            {
-                bytes_to_write = write_processed;
-                p_next = (void *)p_mem;
-            }
-
-            memcpy(p_write, p_src, bytes_to_write);
-            write_processed -= bytes_to_write;
-            write_count += bytes_to_write;
-            *((unsigned long *)(((char *)p_head) + MEM_POOL_OFFSET(t_MemSect, WriteIndex))) += bytes_to_write;
-            p_src = (void *)((unsigned long)(((char *)p_src + bytes_to_write)));
-            p_mem = (void *)p_next;
-            write_index = 0;
+            pPool->Sect_High = pPool->Sect_Used;
         }
     }
-
-    (void)flags;
-    (void)write_index;
-    (void)sect_buf_size;
-    (void)write_processed;
-    (void)bytes_to_write;
-    return write_count;
 }
 
 /* **************************************************************************
- * Function resets write and read pointers of the allocated memory
- *  pMemSect    ->  Pointer to memory sectors start descriptor who needs to be resetted
+ * Function accounts the length of a chain being freed in the histogram, bin n
+ * counts chains of 2^n up to 2^(n+1) - 1 sectors
+ *  pPool       ->  Pointer to the memory header of the chain head
+ *  Length      ->  Number of sectors of the chain
  * Returns none.
  ************************************************************************** */
-void mempool_resetMemory(const void *const pMemSect)
+static void mempool_statChain(struct s_Mem *pPool, unsigned long Length)
 {
-    *((unsigned long *)(((char *)pMemSect) + MEM_POOL_OFFSET(t_MemSect, ReadIndex))) = 0uL;
-    *((unsigned long *)(((char *)pMemSect) + MEM_POOL_OFFSET(t_MemSect, WriteIndex))) = 0uL;
-}
+    unsigned long bin = 0;
 
-/* **************************************************************************
- * Function lets you know how much data can be extracted during next read cycle
- *  pMemSect    ->  Pointer to memory sector start descriptor
- * Returns number of bytes can be read by next read instruction.
- ************************************************************************** */
-unsigned long mempool_availableData(const void *const pMemSect)
-{
-    return *((unsigned long *)(((char *)pMemSect) + MEM_POOL_OFFSET(t_MemSect, WriteIndex))) -\
-                *((unsigned long *)(((char *)pMemSect) + MEM_POOL_OFFSET(t_MemSect, ReadIndex)));
+    while((Length > 1uL) && (bin < (MEM_POOL_HIST_BINS - 1)))
+    {
+        Length >>= 1;
+        bin++;
+    }
+    mempool_statAdd(pPool, &pPool->Chain_Hist[bin], 1uL);
 }
 
 /* **************************************************************************
- * Function counts number of used memory sectors
- *  pMem        ->  Pointer to the top of Heap memory fetched using MEM_POOL_ADDR(Name) macro
- * Returns currently allocated sectors.
+ * Function pops up to Count sectors from the lock-free free list of a
+ * concurrent pool. The list head carries a tag bumped on every update so a
+ * sector popped and pushed back by another thread between the load and the
+ * exchange is caught, the links walked meanwhile are then thrown away.
+ *  pPool       ->  Pointer to the memory header
+ *  ppSect      ->  Array receiving the popped sector descriptors
+ *  Count       ->  Number of sectors wanted
+ * Returns number of sectors popped, zero if pool exhausted
  ************************************************************************** */
-unsigned long mempool_sectUsed(const void *const pMem)
+static unsigned long mempool_popShared(struct s_Mem *pPool, t_MemSect **ppSect, const unsigned long Count)
 {
-    unsigned long index = 0;
-    unsigned long sect_cnt = ((struct s_Mem *)pMem)->Sec_Cnt;
-    unsigned long used_sect_count = 0;
-    void *mem_zero = (void *)((struct s_Mem *)pMem)->Mem_Desc_Start;
+    t_MemSect *p_desc = MEM_POOL_DESC(pPool);
+    t_MemSect *p_next = NULL;
+    unsigned long long top = __atomic_load_n(&pPool->Free_Top, __ATOMIC_ACQUIRE);
+    unsigned long long next = 0;
+    unsigned long popped = 0;
+    uint32_t link = 0;
 
-    for(index = 0; index < sect_cnt; index++)
+    do
     {
-        if(*(((unsigned long *)(((char *)mem_zero) + (memSectorCtxSize * index) + MEM_POOL_OFFSET(t_MemSect, Flags)))) & MEMSECT_FLAGS_USED)
+        popped = 0;
+        // Free list links are links of slot 0, the same encoding as the list head
+        link = (uint32_t)MEM_POOL_TOP_INDEX(top);
+        while((link != 0u) && (popped < Count))
         {
-            // Sector in use
-            used_sect_count += 1;
+            p_next = &p_desc[MEM_POOL_LINK_INDEX(link)];
+            ppSect[popped++] = p_next;
+            // Link may be stale if the sector is taken meanwhile, the exchange then fails
+            link = __atomic_load_n(&p_next->Concat, __ATOMIC_RELAXED);
         }
-    }
+        if(popped == 0)
+        {
+            // Pool exhausted
+            return 0;
+        }
+        next = MEM_POOL_TOP(MEM_POOL_TOP_TAG(top) + 1uLL, link);
+    } while(!__atomic_compare_exchange_n(&pPool->Free_Top, &top, next, 1, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
 
-    (void)sect_cnt;
-    (void)index;
-    return used_sect_count;
+    return popped;
+}
+
+/* **************************************************************************
+ * Function pushes a list of sectors linked through pConcat on the lock-free
+ * free list of a concurrent pool
+ *  pPool       ->  Pointer to the memory header
+ *  pFirst      ->  First sector descriptor of the list, already marked free
+ *  pLast       ->  Last sector descriptor of the list
+ * Returns none.
+ ************************************************************************** */
+static void mempool_pushShared(struct s_Mem *pPool, t_MemSect *pFirst, t_MemSect *pLast)
+{
+    unsigned long long top = __atomic_load_n(&pPool->Free_Top, __ATOMIC_RELAXED);
+    unsigned long long next = 0;
+
+    do
+    {
+        __atomic_store_n(&pLast->Concat, (uint32_t)MEM_POOL_TOP_INDEX(top), __ATOMIC_RELAXED);
+        next = MEM_POOL_TOP(MEM_POOL_TOP_TAG(top) + 1uLL, MEM_POOL_LINK(0u, pFirst->Self));
+    } while(!__atomic_compare_exchange_n(&pPool->Free_Top, &top, next, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+#if defined(MEM_POOL_POSIX)
+/* **************************************************************************
+ * Function wakes the threads waiting for an event of the pool and signals the
+ * eventfd if the event is armed on it, a single load while the pool has never
+ * been waited on and a fence and a load while nobody waits
+ *  pPool       ->  Pointer to the memory header
+ *  Waiters     ->  Wait_Mask bits counting the threads waiting for the event
+ *  Armed       ->  Wait_Mask bit of the event armed on Event_Fd
+ * Returns none.
+ ************************************************************************** */
+static void mempool_notify(struct s_Mem *pPool, const uint32_t Waiters, const uint32_t Armed)
+{
+    uint32_t mask = 0;
+    uint64_t one = 1;
+
+    if(!(__atomic_load_n(&pPool->Wait_Mask, __ATOMIC_RELAXED) & MEM_POOL_WAIT_USED))
+    {
+        // Whoever sets the flag polls until it is seen, see mempool_waitJoin
+        return;
+    }
+    // Pairs with the fence of a waiter between announcing itself and checking again
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    mask = __atomic_load_n(&pPool->Wait_Mask, __ATOMIC_RELAXED);
+    if(mask & Waiters)
+    {
+        __atomic_add_fetch(&pPool->Wait_Seq, 1u, __ATOMIC_RELEASE);
+#if defined(MEM_POOL_FUTEX)
+        (void)syscall(SYS_futex, &pPool->Wait_Seq, (pPool->Flags & MEM_POOL_FLAGS_SHARED) ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE,\
+                        INT_MAX, NULL, NULL, 0);
+#endif
+    }
+    if((mask & Armed) && (__atomic_fetch_and(&pPool->Wait_Mask, ~Armed, __ATOMIC_ACQ_REL) & Armed))
+    {
+        // One shot, mempool_eventFd arms the event again
+        if(write(__atomic_load_n(&pPool->Event_Fd, __ATOMIC_RELAXED), &one, sizeof(one)) != (ssize_t)sizeof(one))
+        {
+            // Counter full, the descriptor is readable anyway
+        }
+    }
+}
+
+/* **************************************************************************
+ * Function announces a waiting thread in Wait_Mask, the count of waiters
+ * saturates instead of carrying into the next field
+ *  pPool       ->  Pointer to the memory header
+ *  Waiter      ->  Wait_Mask bit counting one thread waiting for the event
+ *  Waiters     ->  Wait_Mask bits counting the threads waiting for the event
+ *  pPoll       ->  Set when the thread is not counted or sets MEM_POOL_WAIT_USED,
+ *                  notifications may then be missed and the wait polls
+ * Returns the bits added to the count, to be taken off when the wait ends
+ ************************************************************************** */
+static uint32_t mempool_waitJoin(struct s_Mem *pPool, const uint32_t Waiter, const uint32_t Waiters, int *pPoll)
+{
+    uint32_t mask = __atomic_load_n(&pPool->Wait_Mask, __ATOMIC_RELAXED);
+    uint32_t join = 0;
+
+    do
+    {
+        join = ((mask & Waiters) == Waiters) ? 0u : Waiter;
+    } while(!__atomic_compare_exchange_n(&pPool->Wait_Mask, &mask, (mask + join) | MEM_POOL_WAIT_USED, 1,\
+                                            __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+    *pPoll = (join == 0u) || !(mask & MEM_POOL_WAIT_USED);
+
+    return join;
+}
+
+/* **************************************************************************
+ * Function blocks until the pool wakes its waiters or the deadline passes,
+ * it returns at once when a wake came after Seq was read
+ *  pPool       ->  Pointer to the memory header
+ *  Seq         ->  Wait_Seq as read before the condition was checked
+ *  pDeadline   ->  CLOCK_MONOTONIC time to give up at, NULL waits forever
+ *  Poll        ->  Sleep a millisecond at most, the wake may never come
+ * Returns zero once the deadline has passed.
+ ************************************************************************** */
+static int mempool_waitFor(struct s_Mem *pPool, const uint32_t Seq, const struct timespec *pDeadline, const int Poll)
+{
+    struct timespec now;
+    struct timespec left = { 0, 1000000L };
+    struct timespec *p_left = NULL;
+#if defined(MEM_POOL_FUTEX)
+    const int poll = Poll;
+#else
+    // No futex, the condition is polled every millisecond
+    const int poll = 1;
+#endif
+
+    if(pDeadline != NULL)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        left.tv_sec = pDeadline->tv_sec - now.tv_sec;
+        left.tv_nsec = pDeadline->tv_nsec - now.tv_nsec;
+        if(left.tv_nsec < 0)
+        {
+            left.tv_sec--;
+            left.tv_nsec += 1000000000L;
+        }
+        if(left.tv_sec < 0)
+        {
+            return 0;
+        }
+        p_left = &left;
+    }
+
+    if(poll && ((p_left == NULL) || (left.tv_sec > 0) || (left.tv_nsec > 1000000L)))
+    {
+        left.tv_sec = 0;
+        left.tv_nsec = 1000000L;
+        p_left = &left;
+    }
+
+#if defined(MEM_POOL_FUTEX)
+    (void)syscall(SYS_futex, &pPool->Wait_Seq, (pPool->Flags & MEM_POOL_FLAGS_SHARED) ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE,\
+                    Seq, p_left, NULL, 0);
+#else
+    (void)pPool;
+    (void)Seq;
+    (void)Poll;
+    (void)nanosleep(p_left, NULL);
+#endif
+
+    return 1;
+}
+
+/* **************************************************************************
+ * Function turns a timeout into the time to give up at
+ *  pDeadline   ->  Receives the CLOCK_MONOTONIC deadline
+ *  Timeout     ->  Milliseconds to wait, negative waits forever
+ * Returns pDeadline, NULL for no deadline
+ ************************************************************************** */
+static struct timespec *mempool_deadline(struct timespec *pDeadline, const long Timeout)
+{
+    if(Timeout < 0)
+    {
+        return NULL;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, pDeadline);
+    pDeadline->tv_sec += Timeout / 1000L;
+    pDeadline->tv_nsec += (Timeout % 1000L) * 1000000L;
+    if(pDeadline->tv_nsec >= 1000000000L)
+    {
+        pDeadline->tv_sec++;
+        pDeadline->tv_nsec -= 1000000000L;
+    }
+
+    return pDeadline;
+}
+#endif
+
+#if defined(MEM_POOL_POSIX)
+/* **************************************************************************
+ * Function makes the pages under an address range of a reservation usable
+ *  Start       ->  First byte of the range
+ *  End         ->  Byte past the range
+ * Returns non zero on success.
+ ************************************************************************** */
+static int mempool_mapCommit(const uintptr_t Start, const uintptr_t End)
+{
+    uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t from = Start & ~(page - 1u);
+    uintptr_t to = (End + page - 1u) & ~(page - 1u);
+
+    return (to <= from) || (mprotect((void *)from, to - from, PROT_READ | PROT_WRITE) == 0);
+}
+
+/* **************************************************************************
+ * Function gives the pages lying wholly inside an address range back to the
+ * system and makes them inaccessible again
+ *  Start       ->  First byte of the range
+ *  End         ->  Byte past the range
+ * Returns none.
+ ************************************************************************** */
+static void mempool_mapRelease(const uintptr_t Start, const uintptr_t End)
+{
+    uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t from = (Start + page - 1u) & ~(page - 1u);
+    uintptr_t to = End & ~(page - 1u);
+
+    if(to > from)
+    {
+        (void)madvise((void *)from, to - from, MADV_DONTNEED);
+        (void)mprotect((void *)from, to - from, PROT_NONE);
+    }
+}
+#endif
+
+/* **************************************************************************
+ * Function adds a segment of Grow_Step sectors to an exhausted growable
+ * pool, only one thread grows a pool at a time and the others yield until
+ * it is done
+ *  pPool       ->  Pointer to the memory header
+ *  Seen        ->  Sec_Cnt read before the free list came up empty
+ * Returns non zero if the free list is worth another try.
+ ************************************************************************** */
+static unsigned long mempool_grow(struct s_Mem *pPool, const unsigned long Seen)
+{
+#if defined(MEM_POOL_POSIX)
+    t_MemSect *p_desc = MEM_POOL_DESC(pPool);
+    unsigned long from = 0;
+    unsigned long to = 0;
+
+    if(!(pPool->Flags & MEM_POOL_FLAGS_GROWABLE))
+    {
+        return 0;
+    }
+    if(__atomic_exchange_n(&pPool->Grow_Lock, 1uL, __ATOMIC_ACQUIRE) != 0uL)
+    {
+        // Another thread is in the mprotect calls, its segment is on the free list once the lock is back
+        while(__atomic_load_n(&pPool->Grow_Lock, __ATOMIC_RELAXED) != 0uL)
+        {
+            (void)sched_yield();
+        }
+        return 1;
+    }
+
+    from = __atomic_load_n(&pPool->Sec_Cnt, __ATOMIC_RELAXED);
+    if(from != Seen)
+    {
+        // Another thread grew the pool meanwhile
+        __atomic_store_n(&pPool->Grow_Lock, 0uL, __ATOMIC_RELEASE);
+        return 1;
+    }
+    to = ((pPool->Sec_Max - from) < pPool->Grow_Step) ? pPool->Sec_Max : (from + pPool->Grow_Step);
+    if((to == from) ||\
+        !mempool_mapCommit((uintptr_t)&p_desc[from], (uintptr_t)&p_desc[to]) ||\
+        !mempool_mapCommit((uintptr_t)&MEM_POOL_HEADS(pPool)[from], (uintptr_t)&MEM_POOL_HEADS(pPool)[to]) ||\
+        !mempool_mapCommit(MEM_POOL_DATA(pPool) + (from * pPool->Sec_Stride), MEM_POOL_DATA(pPool) + (to * pPool->Sec_Stride)))
+    {
+        // Upper bound reached or no memory left to commit
+        __atomic_store_n(&pPool->Grow_Lock, 0uL, __ATOMIC_RELEASE);
+        return 0;
+    }
+
+    mempool_sectPrepare(pPool, from, to);
+    if(pPool->Flags & MEM_POOL_FLAGS_CONCURRENT)
+    {
+        mempool_pushShared(pPool, &p_desc[from], &p_desc[to - 1]);
+    }
+    else
+    {
+        p_desc[to - 1].Concat = (uint32_t)pPool->Free_Head;
+        pPool->Free_Head = MEM_POOL_LINK(0u, from);
+    }
+    __atomic_store_n(&pPool->Sec_Cnt, to, __ATOMIC_RELEASE);
+    __atomic_store_n(&pPool->Grow_Lock, 0uL, __ATOMIC_RELEASE);
+
+    return 1;
+#else
+    (void)pPool;
+    (void)Seen;
+    return 0;
+#endif
+}
+
+/* **************************************************************************
+ * Function pops up to Count sectors from the free list of the pool
+ *  pPool       ->  Pointer to the memory header
+ *  ppSect      ->  Array receiving the popped sector descriptors
+ *  Count       ->  Number of sectors wanted
+ * Returns number of sectors popped, zero if pool exhausted
+ ************************************************************************** */
+static unsigned long mempool_popFree(struct s_Mem *pPool, t_MemSect **ppSect, const unsigned long Count)
+{
+    t_MemSect *p_sect = NULL;
+    uint32_t link = 0;
+    unsigned long popped = 0;
+    unsigned long seen = 0;
+
+    do
+    {
+        seen = __atomic_load_n(&pPool->Sec_Cnt, __ATOMIC_ACQUIRE);
+        if(pPool->Flags & MEM_POOL_FLAGS_CONCURRENT)
+        {
+            popped += mempool_popShared(pPool, &ppSect[popped], Count - popped);
+        }
+        else
+        {
+            link = (uint32_t)pPool->Free_Head;
+            while((link != 0u) && (popped < Count))
+            {
+                p_sect = &MEM_POOL_DESC(pPool)[MEM_POOL_LINK_INDEX(link)];
+                ppSect[popped++] = p_sect;
+                link = p_sect->Concat;
+            }
+            pPool->Free_Head = link;
+        }
+    } while((popped < Count) && (pPool->Flags & MEM_POOL_FLAGS_GROWABLE) && mempool_grow(pPool, seen));
+
+    if(popped != 0)
+    {
+        mempool_statUsed(pPool, popped);
+    }
+    else
+    {
+        mempool_statAdd(pPool, &pPool->Alloc_Fail, 1uL);
+    }
+
+    return popped;
+}
+
+/* **************************************************************************
+ * Function pushes a list of sectors linked through pConcat on the free list
+ *  pPool       ->  Pointer to the memory header
+ *  pFirst      ->  First sector descriptor of the list, already marked free
+ *  pLast       ->  Last sector descriptor of the list
+ *  Count       ->  Number of sectors in the list
+ * Returns none.
+ ************************************************************************** */
+static void mempool_pushFree(struct s_Mem *pPool, t_MemSect *pFirst, t_MemSect *pLast, const unsigned long Count)
+{
+    mempool_statAdd(pPool, &pPool->Sect_Used, 0uL - Count);
+
+    if(pPool->Flags & MEM_POOL_FLAGS_CONCURRENT)
+    {
+        mempool_pushShared(pPool, pFirst, pLast);
+#if defined(MEM_POOL_POSIX)
+        mempool_notify(pPool, MEM_POOL_WAIT_FREE_ALL, MEM_POOL_ARMED_FREE);
+#endif
+    }
+    else
+    {
+        pLast->Concat = (uint32_t)pPool->Free_Head;
+        pPool->Free_Head = MEM_POOL_LINK(0u, pFirst->Self);
+    }
+}
+
+/* **************************************************************************
+ * Function hands a sector taken from the free list over to the user
+ *  pSect       ->  Pointer to sector descriptor
+ * Returns none.
+ ************************************************************************** */
+static void mempool_sectClaim(t_MemSect *pSect)
+{
+    t_MemHead *p_state = mempool_sectHead(pSect);
+
+    // Other threads may still be reading the stale free list link
+    __atomic_store_n(&pSect->Flags, MEMSECT_FLAGS_USED, __ATOMIC_RELAXED);
+    __atomic_store_n(&pSect->Concat, 0u, __ATOMIC_RELAXED);
+    pSect->Gap = 0u;
+    p_state->ReadIndex = 0uL;
+    p_state->WriteIndex = 0uL;
+    p_state->Write = MEM_POOL_LINK(0u, pSect->Self);
+    p_state->WriteBase = 0uL;
+    p_state->Read = MEM_POOL_LINK(0u, pSect->Self);
+    p_state->ReadBase = 0uL;
+}
+
+/* **************************************************************************
+ * Function marks an allocated sector free, a concurrent pool claims the flags
+ * atomically so a racing double free of the sector is harmless. A sector
+ * other chains still reference only loses one reference.
+ *  pPool       ->  Pointer to the memory header owning the sector
+ *  pSect       ->  Pointer to sector descriptor
+ * Returns the sector flags before release, MEMSECT_FLAGS_NONE if already free,
+ * the sector stays allocated if they count references in MEMSECT_FLAGS_REFS
+ ************************************************************************** */
+static unsigned long mempool_sectRelease(struct s_Mem *pPool, t_MemSect *pSect)
+{
+    uint32_t flags = MEMSECT_FLAGS_NONE;
+    uint32_t next = MEMSECT_FLAGS_NONE;
+
+    if(pPool->Flags & MEM_POOL_FLAGS_CONCURRENT)
+    {
+        flags = __atomic_load_n(&pSect->Flags, __ATOMIC_RELAXED);
+        while(flags != MEMSECT_FLAGS_NONE)
+        {
+            next = (flags & MEMSECT_FLAGS_REFS) ? (flags - MEMSECT_FLAGS_REF) : MEMSECT_FLAGS_NONE;
+            if(__atomic_compare_exchange_n(&pSect->Flags, &flags, next, 1, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+    }
+    else
+    {
+        flags = pSect->Flags;
+        pSect->Flags = (flags & MEMSECT_FLAGS_REFS) ? (flags - MEMSECT_FLAGS_REF) : MEMSECT_FLAGS_NONE;
+    }
+
+    return flags;
+}
+
+/* **************************************************************************
+ * Function tells if the data of a chain is shared with other chains, either
+ * through a clone of it or as a clone itself. Such a chain is read only.
+ *  pHead       ->  Pointer to memory sector start descriptor
+ * Returns non zero if the chain shares its sectors
+ ************************************************************************** */
+static unsigned long mempool_chainShared(const t_MemSect *pHead)
+{
+    return __atomic_load_n(&pHead->Flags, __ATOMIC_RELAXED) & (MEMSECT_FLAGS_REFS | MEMSECT_FLAGS_CLONE);
+}
+
+/* **************************************************************************
+ * Function gives the usable size of a sector, chains may span pools of a group
+ * so the size always comes from the pool owning the sector
+ *  pSect       ->  Pointer to sector descriptor
+ * Returns size of the sector buffer in bytes
+ ************************************************************************** */
+static unsigned long mempool_sectSize(const void *const pSect)
+{
+    return mempool_sectPool((t_MemSect *)pSect)->Sec_Size;
+}
+
+/* **************************************************************************
+ * Function gives the bytes a sector holds for readers, a sector a splice left
+ * short ends its data Gap bytes before the end of its buffer
+ *  pSect       ->  Pointer to sector descriptor
+ * Returns bytes of the sector buffer in use by the chain
+ ************************************************************************** */
+static unsigned long mempool_sectFill(const void *const pSect)
+{
+    return mempool_sectSize(pSect) - ((t_MemSect *)pSect)->Gap;
+}
+
+/* **************************************************************************
+ * Function gives every sector of a spliced chain back its full size, called
+ * when the write index returns to the head sector
+ *  pHead       ->  Pointer to memory sector start descriptor
+ * Returns none.
+ ************************************************************************** */
+static void mempool_gapClear(t_MemSect *pHead)
+{
+    t_MemSect *p_mem = pHead;
+
+    if(!(pHead->Flags & MEMSECT_FLAGS_SPLICED))
+    {
+        return;
+    }
+    while(p_mem != NULL)
+    {
+        p_mem->Gap = 0u;
+        p_mem = (p_mem->Flags & MEMSECT_FLAGS_CONCAT) ? mempool_sectNext(p_mem) : NULL;
+    }
+    pHead->Flags &= ~MEMSECT_FLAGS_SPLICED;
+}
+
+/* **************************************************************************
+ * Function gives the start of the sector buffer, worked out from the index of
+ * the sector
+ *  pSect       ->  Pointer to sector descriptor
+ * Returns pointer to the first byte of the sector buffer
+ ************************************************************************** */
+static char *mempool_sectData(const void *const pSect)
+{
+    struct s_Mem *p_pool = mempool_sectPool((t_MemSect *)pSect);
+
+    return (char *)MEM_POOL_DATA(p_pool) + (p_pool->Sec_Stride * ((t_MemSect *)pSect)->Self);
+}
+
+/* **************************************************************************
+ * Function gives the sector concatenated after the given one, a new sector is
+ * allocated and concatenated when the chain ends there
+ *  pMem        ->  Pointer to the memory the chain grows from, unused with a group
+ *  pGroup      ->  Pointer to the pool group the chain grows from, NULL for pMem
+ *  pHead       ->  Pointer to the head of the chain keeping links to its cursors,
+ *                  NULL when the cursors are kept elsewhere
+ *  pSect       ->  Pointer to sector descriptor to be followed
+ *  Want        ->  Bytes still to be stored, picks the size class of a group
+ * Returns the next Sector Pointer, NULL if the pool is exhausted
+ ************************************************************************** */
+static t_MemSect *mempool_sectExtend(const void *const pMem, const t_MemGroup *const pGroup, const t_MemSect *pHead,\
+                                        t_MemSect *pSect, const unsigned long Want)
+{
+    t_MemSect *p_next = NULL;
+    unsigned long sect_buf_size = 0;
+    uint32_t link = 0;
+
+    if(pSect->Flags & MEMSECT_FLAGS_CONCAT)
+    {
+        return mempool_sectNext(pSect);
+    }
+
+    if(pGroup != NULL)
+    {
+        sect_buf_size = mempool_sectSize(pSect);
+        p_next = (t_MemSect *)mempool_groupAlloc(pGroup, (Want > sect_buf_size) ? Want : sect_buf_size);
+    }
+    else
+    {
+        p_next = (t_MemSect *)mempool_alloc(pMem);
+    }
+
+    if(p_next != NULL)
+    {
+        link = mempool_sectLink(pSect, p_next);
+        if((link == 0u) || ((pHead != NULL) && (mempool_sectLink(pHead, p_next) == 0u)))
+        {
+            // Chain already spans MEM_POOL_PEER_MAX other pools
+            mempool_chainRelease(p_next, NULL);
+            return NULL;
+        }
+        // Stale free list walkers may still read the link
+        __atomic_store_n(&pSect->Concat, link, __ATOMIC_RELAXED);
+        pSect->Flags |= MEMSECT_FLAGS_CONCAT;
+        mempool_statAdd(mempool_sectPool(p_next), &mempool_sectPool(p_next)->Alloc_Extend, 1uL);
+    }
+
+    return p_next;
+}
+
+/* **************************************************************************
+ * Function moves a chain cursor forward, the cursor steps into the following
+ * sector once its sector is used up and another one is concatenated
+ *  ppSect      ->  Cursor sector
+ *  pBase       ->  Index at which the cursor sector starts
+ *  Index       ->  New value of the index the cursor follows
+ * Returns none.
+ ************************************************************************** */
+static void mempool_cursorSeek(t_MemSect **ppSect, unsigned long *pBase, const unsigned long Index)
+{
+    while(((Index - *pBase) >= mempool_sectFill(*ppSect)) && ((*ppSect)->Flags & MEMSECT_FLAGS_CONCAT))
+    {
+        *pBase += mempool_sectFill(*ppSect);
+        *ppSect = mempool_sectNext(*ppSect);
+    }
+}
+
+/* **************************************************************************
+ * Function moves a cursor kept in the chain state of a head forward
+ *  pHead       ->  Pointer to memory sector start descriptor
+ *  pLink       ->  Cursor link, Read or Write of the chain state
+ *  pBase       ->  Index at which the cursor sector starts, ReadBase or WriteBase
+ *  Index       ->  New value of the index the cursor follows
+ * Returns none.
+ ************************************************************************** */
+static void mempool_headSeek(const t_MemSect *pHead, uint32_t *pLink, unsigned long *pBase, const unsigned long Index)
+{
+    t_MemSect *p_sect = mempool_linkSect(pHead, *pLink);
+
+    mempool_cursorSeek(&p_sect, pBase, Index);
+    *pLink = mempool_sectLink(pHead, p_sect);
+}
+
+/* **************************************************************************
+ * Function prepares free sector descriptors and chains them through Concat,
+ * the last one ends the list
+ *  pPool       ->  Pointer to the memory header
+ *  From        ->  Index of the first descriptor
+ *  To          ->  Index past the last descriptor
+ * Returns none.
+ ************************************************************************** */
+static void mempool_sectPrepare(struct s_Mem *pPool, const unsigned long From, const unsigned long To)
+{
+    t_MemSect *p_desc = MEM_POOL_DESC(pPool);
+    t_MemHead *p_state = MEM_POOL_HEADS(pPool);
+    unsigned long index = 0;
+
+    for(index = From; index < To; index++)
+    {
+        // Preparing sector headers
+        // Resetting all the flags from all the sectors
+        p_desc[index].Flags = MEMSECT_FLAGS_NONE;
+        // Position in the pool, buffer and owner are worked out from it
+        p_desc[index].Self = (uint32_t)index;
+        // Free sectors are chained through the concatenation link, last one ends the free list
+        p_desc[index].Concat = ((index + 1) < To) ? MEM_POOL_LINK(0u, index + 1) : 0u;
+        p_desc[index].Gap = 0u;
+        // Resetting the read and write index to 0
+        memset(&p_state[index], 0, sizeof(p_state[index]));
+    }
+}
+
+/* **************************************************************************
+ * Function works out MEM_POOL_BYTES at run time without wrapping around,
+ * leaving room to round the result up to a huge page
+ *  SectCnt     ->  Number of sectors of the pool
+ *  SectSize    ->  Size of each memory sector
+ * Returns bytes the pool needs, zero if they do not fit an unsigned long, a
+ * sector is empty or larger than the 32 bit Gap of a descriptor can describe
+ ************************************************************************** */
+static unsigned long mempool_poolBytes(const unsigned long SectCnt, const unsigned long SectSize)
+{
+    const unsigned long fixed = MEM_POOL_ROUND(memCtxSize) + (4u * MEM_POOL_ALIGN) + MEM_POOL_HUGE_PAGE;
+
+    if((SectSize == 0uL) || (SectSize > UINT32_MAX) || (MEM_POOL_ROUND(SectSize) < SectSize) ||\
+        ((SectCnt != 0uL) && ((MEM_POOL_ROUND(SectSize) + memSectorCtxSize + memHeadCtxSize) > ((ULONG_MAX - fixed) / SectCnt))))
+    {
+        return 0;
+    }
+
+    return (unsigned long)MEM_POOL_BYTES(SectCnt, SectSize);
+}
+
+/* **************************************************************************
+ * Function lays the pool out for SectMax sectors and prepares the first
+ * SectCnt of them, the rest is left for mempool_grow
+ *  pMem        ->  Pointer to the memory, rounded up to MEM_POOL_ALIGN
+ *  Size        ->  Size of the memory
+ *  SectCnt     ->  Number of sectors usable from the start
+ *  SectMax     ->  Number of sectors the layout leaves room for
+ *  SectSize    ->  Size of each memory sector
+ *  Flags       ->  Pool behaviour flags
+ * Returns the memory header.
+ ************************************************************************** */
+static struct s_Mem *mempool_layout(const void *const pMem, const unsigned long Size, const unsigned long SectCnt,\
+                                        const unsigned long SectMax, const unsigned long SectSize, const unsigned long Flags)
+{
+    struct s_Mem *p_pool = (struct s_Mem *)MEM_POOL_ROUND((uintptr_t)pMem);
+
+    // Number of sectors of memory
+    p_pool->Sec_Cnt = (unsigned long)SectCnt;
+    // Bounds of a growable pool, both are Sec_Cnt otherwise
+    p_pool->Sec_Min = (unsigned long)SectCnt;
+    p_pool->Sec_Max = (unsigned long)SectMax;
+    p_pool->Grow_Step = 0uL;
+    p_pool->Grow_Lock = 0uL;
+    // Size of each sector
+    p_pool->Sec_Size = (unsigned long)SectSize;
+    // Sector buffers start on MEM_POOL_ALIGN boundaries
+    p_pool->Sec_Stride = (unsigned long)MEM_POOL_ROUND(SectSize);
+    // Start of memory sector descriptors, all starts are offsets from the header
+    p_pool->Mem_Desc_Start = MEM_POOL_ROUND(memCtxSize);
+    // Start of chain states, one per sector
+    p_pool->Mem_Head_Start = p_pool->Mem_Desc_Start + MEM_POOL_ROUND(SectMax * memSectorCtxSize);
+    // Start of usable memory sectors
+    p_pool->Mem_Start = p_pool->Mem_Head_Start + MEM_POOL_ROUND(SectMax * memHeadCtxSize);
+    // Memory left for the pool once the start is aligned
+    p_pool->Total_Memory = (unsigned long)(Size - ((uintptr_t)p_pool - (uintptr_t)pMem));
+    // Every sector is free, the free list starts with the first descriptor
+    p_pool->Free_Head = (SectCnt != 0) ? MEM_POOL_LINK(0u, 0u) : 0u;
+    p_pool->Free_Top = MEM_POOL_TOP(0uL, (SectCnt != 0) ? 1uL : 0uL);
+    // Not mapped by mempool_create until it says so
+    p_pool->Map_Size = 0u;
+    // Nobody waits yet and no eventfd is open
+    p_pool->Wait_Seq = 0u;
+    p_pool->Wait_Mask = 0u;
+    p_pool->Event_Fd = -1;
+    // Pool behaviour
+    p_pool->Flags = Flags;
+    // Counters start from zero
+    p_pool->Sect_Used = 0uL;
+    p_pool->Sect_High = 0uL;
+    p_pool->Alloc_Fail = 0uL;
+    p_pool->Alloc_Extend = 0uL;
+    memset(p_pool->Bytes, 0, sizeof(p_pool->Bytes));
+    memset(p_pool->Chain_Hist, 0, sizeof(p_pool->Chain_Hist));
+    // No chain continues into another pool yet
+    memset(p_pool->pPeer, 0, sizeof(p_pool->pPeer));
+
+    mempool_sectPrepare(p_pool, 0uL, SectCnt);
+
+    return p_pool;
+}
+
+/* **************************************************************************
+ * Function initializes the memory section for future use
+ *  pMem        ->  Pointer to the memory fetched using MEM_POOL_ADDR(Name) macro
+ *  Size        ->  Size of memory fetched using MEM_POOL_SIZE(Name) macro
+ *  SectCnt     ->  Number of Sectors of memory blocks fetched using MEM_POOL_CNT(Name) macro
+ *  SectSize    ->  Size of memory sector fetched using MEM_POOL_SECT_SIZE(Name) macro
+ * Returns the start address of the current initialized Heap, pMem rounded up
+ * to MEM_POOL_ALIGN, which every other call takes as the pool. NULL if Size
+ * is short of MEM_POOL_BYTES, SectCnt exceeds MEM_POOL_SECT_LIMIT or SectSize
+ * is zero or exceeds 32 bits.
+ ************************************************************************** */
+void *mempool_init(const void *const pMem, const unsigned long Size, const unsigned long SectCnt, const unsigned long SectSize)
+{
+    return mempool_initWithFlags(pMem, Size, SectCnt, SectSize, MEM_POOL_FLAGS_NONE);
+}
+
+/* **************************************************************************
+ * Function initializes the memory section with pool wide behaviour flags
+ *  pMem        ->  Pointer to the memory fetched using MEM_POOL_ADDR(Name) macro
+ *  Size        ->  Size of memory fetched using MEM_POOL_SIZE(Name) macro
+ *  SectCnt     ->  Number of Sectors of memory blocks fetched using MEM_POOL_CNT(Name) macro
+ *  SectSize    ->  Size of memory sector fetched using MEM_POOL_SECT_SIZE(Name) macro
+ *  Flags       ->  MEM_POOL_FLAGS_CONCURRENT lets mempool_alloc and mempool_free
+ *                  be called from several threads at once without a lock,
+ *                  MEM_POOL_FLAGS_NONE behaves as mempool_init
+ * Returns the start address of the current initialized Heap, pMem rounded up
+ * to MEM_POOL_ALIGN, which every other call takes as the pool. NULL if Size
+ * is short of MEM_POOL_BYTES, SectCnt exceeds MEM_POOL_SECT_LIMIT or SectSize
+ * is zero or exceeds 32 bits.
+ ************************************************************************** */
+void *mempool_initWithFlags(const void *const pMem, const unsigned long Size, const unsigned long SectCnt,\
+                                const unsigned long SectSize, const unsigned long Flags)
+{
+    const unsigned long pool_bytes = mempool_poolBytes(SectCnt, SectSize);
+
+    if((SectCnt > MEM_POOL_SECT_LIMIT) || (pool_bytes == 0uL) || (Size < pool_bytes))
+    {
+        // Sector index no longer fits a link or the memory is too small for the pool
+        return NULL;
+    }
+
+    return (void *)mempool_layout(pMem, Size, SectCnt, SectCnt, SectSize, Flags);
+}
+
+/* **************************************************************************
+ * Function allocates the unallocated memory sector for the user
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_init
+ * Returns the Sector Pointer if available else returns NULL
+ ************************************************************************** */
+void *mempool_alloc(const void *const pMem)
+{
+    t_MemSect *p_sect = NULL;
+
+    if(mempool_popFree((struct s_Mem *)pMem, &p_sect, 1uL) != 0uL)
+    {
+        mempool_sectClaim(p_sect);
+    }
+
+    return (void *)p_sect;
+}
+
+/* **************************************************************************
+ * Function pushes the sectors collected in a run on the free list of their pool
+ *  pRun        ->  Pointer to the run, emptied afterwards
+ * Returns none.
+ ************************************************************************** */
+static void mempool_runFlush(t_MemRun *pRun)
+{
+    if(pRun->pFirst != NULL)
+    {
+        mempool_pushFree(pRun->pPool, pRun->pFirst, pRun->pLast, pRun->Count);
+        pRun->pFirst = NULL;
+        pRun->pLast = NULL;
+        pRun->Count = 0;
+    }
+}
+
+/* **************************************************************************
+ * Function releases the sectors of a chain into a run, consecutive sectors of
+ * the same pool reach the free list with a single push
+ *  pRun        ->  Pointer to the run collecting released sectors
+ *  pFirst      ->  First sector descriptor to be released
+ *  pStop       ->  Sector descriptor ending the chain, not released, NULL
+ *                  releases up to the end of the chain
+ * Returns number of sectors released.
+ ************************************************************************** */
+static unsigned long mempool_runCollect(t_MemRun *pRun, t_MemSect *pFirst, const t_MemSect *pStop)
+{
+    unsigned long flags = MEMSECT_FLAGS_NONE;
+    unsigned long released = 0;
+    t_MemSect *p_mem = pFirst;
+    t_MemSect *p_concat = NULL;
+    struct s_Mem *p_pool = NULL;
+
+    while((p_mem != NULL) && (p_mem != pStop))
+    {
+        p_pool = mempool_sectPool(p_mem);
+        // Link resolved first, the free list reuses it once the sector is released
+        p_concat = mempool_sectNext(p_mem);
+        flags = mempool_sectRelease(p_pool, p_mem);
+        if(flags == MEMSECT_FLAGS_NONE)
+        {
+            // Sector is already free
+            break;
+        }
+        if(flags & MEMSECT_FLAGS_REFS)
+        {
+            // Another chain still reads this sector and every one after it
+            break;
+        }
+
+        if(p_pool != pRun->pPool)
+        {
+            mempool_runFlush(pRun);
+            pRun->pPool = p_pool;
+        }
+        if(pRun->pFirst == NULL)
+        {
+            pRun->pFirst = p_mem;
+        }
+        else
+        {
+            __atomic_store_n(&pRun->pLast->Concat, MEM_POOL_LINK(0u, p_mem->Self), __ATOMIC_RELAXED);
+        }
+        pRun->pLast = p_mem;
+        pRun->Count++;
+        released++;
+        p_mem = (flags & MEMSECT_FLAGS_CONCAT) ? p_concat : NULL;
+    }
+
+    return released;
+}
+
+/* **************************************************************************
+ * Function returns the sectors of a chain to their pools
+ *  pFirst      ->  First sector descriptor to be released
+ *  pStop       ->  Sector descriptor ending the run, not released, NULL
+ *                  releases up to the end of the chain
+ * Returns none.
+ ************************************************************************** */
+static void mempool_chainRelease(t_MemSect *pFirst, const t_MemSect *pStop)
+{
+    t_MemRun run = { NULL, NULL, NULL, 0 };
+
+    mempool_runCollect(&run, pFirst, pStop);
+    mempool_runFlush(&run);
+}
+
+/* **************************************************************************
+ * Function releases the sectors a reclaim mode chain has fully read, the head
+ * sector stays as it is the handle of the chain. Sectors between the head and
+ * the read sector go back to the pool and all indices are rebased, a drained
+ * chain starts over in the head sector.
+ *  pHead       ->  Pointer to memory sector start descriptor
+ * Returns none.
+ ************************************************************************** */
+static void mempool_chainReclaim(t_MemSect *pHead)
+{
+    t_MemHead *p_state = mempool_sectHead(pHead);
+    t_MemSect *p_read = NULL;
+    unsigned long released = 0;
+
+    if(mempool_chainShared(pHead))
+    {
+        // Sectors read here may still be unread by the other chains
+        return;
+    }
+
+    // Both cursors as far as the indices allow, the write one never trails the read one
+    mempool_headSeek(pHead, &p_state->Write, &p_state->WriteBase, p_state->WriteIndex);
+    mempool_headSeek(pHead, &p_state->Read, &p_state->ReadBase, p_state->ReadIndex);
+
+    p_read = mempool_linkSect(pHead, p_state->Read);
+    if((p_read != pHead) && (pHead->Concat != p_state->Read))
+    {
+        released = p_state->ReadBase - mempool_sectFill(pHead);
+        mempool_chainRelease(mempool_sectNext(pHead), p_read);
+        pHead->Concat = p_state->Read;
+        p_state->ReadIndex -= released;
+        p_state->WriteIndex -= released;
+        p_state->ReadBase -= released;
+        p_state->WriteBase -= released;
+    }
+
+    if(p_state->ReadIndex == p_state->WriteIndex)
+    {
+        // Drained, sectors still concatenated are reused by the next writes
+        mempool_gapClear(pHead);
+        p_state->ReadIndex = 0uL;
+        p_state->WriteIndex = 0uL;
+        p_state->Read = MEM_POOL_LINK(0u, pHead->Self);
+        p_state->ReadBase = 0uL;
+        p_state->Write = MEM_POOL_LINK(0u, pHead->Self);
+        p_state->WriteBase = 0uL;
+    }
+}
+
+/* **************************************************************************
+ * Function allocates Count sectors at once, either all of them or none
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_init
+ *  ppMemSect   ->  Array receiving the Sector Pointers
+ *  Count       ->  Number of sectors wanted
+ * Returns Count if all sectors are allocated, zero otherwise or for no sectors
+ ************************************************************************** */
+unsigned long mempool_allocBulk(const void *const pMem, void **const ppMemSect, const unsigned long Count)
+{
+    t_MemSect **p_sect = (t_MemSect **)ppMemSect;
+    unsigned long popped = 0;
+    unsigned long index = 0;
+
+    if(Count == 0uL)
+    {
+        // Nothing asked for, the free list and the counters stay as they are
+        return 0;
+    }
+    popped = mempool_popFree((struct s_Mem *)pMem, p_sect, Count);
+    if(popped < Count)
+    {
+        // Not enough sectors, hand the partial batch back untouched
+        for(index = 1; index < popped; index++)
+        {
+            __atomic_store_n(&p_sect[index - 1]->Concat, MEM_POOL_LINK(0u, p_sect[index]->Self), __ATOMIC_RELAXED);
+        }
+        if(popped != 0)
+        {
+            mempool_pushFree((struct s_Mem *)pMem, p_sect[0], p_sect[popped - 1], popped);
+            mempool_statAdd((struct s_Mem *)pMem, &((struct s_Mem *)pMem)->Alloc_Fail, 1uL);
+        }
+        return 0;
+    }
+
+    for(index = 0; index < Count; index++)
+    {
+        mempool_sectClaim(p_sect[index]);
+    }
+
+    return Count;
+}
+
+/* **************************************************************************
+ * Function frees several allocated sector chains at once, sectors of the
+ * same pool go back to the free list with a single push
+ *  ppMemSect   ->  Array of memory sector start descriptors, NULL entries skipped
+ *  Count       ->  Number of entries in the array
+ * Returns none.
+ ************************************************************************** */
+void mempool_freeBulk(void *const *const ppMemSect, const unsigned long Count)
+{
+    t_MemRun run = { NULL, NULL, NULL, 0 };
+    unsigned long index = 0;
+    unsigned long released = 0;
+
+    for(index = 0; index < Count; index++)
+    {
+        released = mempool_runCollect(&run, (t_MemSect *)ppMemSect[index], NULL);
+        if(released != 0)
+        {
+            mempool_statChain(mempool_sectPool((t_MemSect *)ppMemSect[index]), released);
+        }
+    }
+    mempool_runFlush(&run);
+}
+
+/* **************************************************************************
+ * Function frees the allocated sector
+ *  pMemSect    ->  Pointer to memory sector descriptor which needs to be marked
+ *                  free for the future use.
+ * Returns none.
+ ************************************************************************** */
+void mempool_free(const void *const pMemSect)
+{
+    t_MemRun run = { NULL, NULL, NULL, 0 };
+    unsigned long released = 0;
+
+    released = mempool_runCollect(&run, (t_MemSect *)pMemSect, NULL);
+    if(released != 0)
+    {
+        mempool_statChain(mempool_sectPool((t_MemSect *)pMemSect), released);
+    }
+    mempool_runFlush(&run);
+}
+
+/* **************************************************************************
+ * Function allocates a sector as a fixed size object, the sector buffer is
+ * handed out directly and no read or write index is kept for it
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_init
+ * Returns pointer to the object, MEM_POOL_ALIGN aligned and Sec_Size bytes
+ * long, NULL if the pool is exhausted
+ ************************************************************************** */
+void *mempool_objAlloc(const void *const pMem)
+{
+    struct s_Mem *p_pool = (struct s_Mem *)pMem;
+    t_MemSect *p_sect = NULL;
+
+    if(mempool_popFree(p_pool, &p_sect, 1uL) == 0uL)
+    {
+        return NULL;
+    }
+
+    // Objects never head a chain, their chain state is left untouched
+    __atomic_store_n(&p_sect->Flags, MEMSECT_FLAGS_USED | MEMSECT_FLAGS_OBJ, __ATOMIC_RELAXED);
+    __atomic_store_n(&p_sect->Concat, 0u, __ATOMIC_RELAXED);
+
+    return (void *)((char *)MEM_POOL_DATA(p_pool) + (p_pool->Sec_Stride * p_sect->Self));
+}
+
+/* **************************************************************************
+ * Function frees an object of mempool_objAlloc, its descriptor is found from
+ * the object address relative to Mem_Start
+ *  pMem        ->  Pointer to the top of Heap memory the object came from
+ *  pObj        ->  Pointer to the object, NULL and pointers that are not an
+ *                  object of the pool in use, such as chain buffers, are ignored
+ * Returns none.
+ ************************************************************************** */
+void mempool_objFree(const void *const pMem, const void *const pObj)
+{
+    struct s_Mem *p_pool = (struct s_Mem *)pMem;
+    t_MemSect *p_sect = NULL;
+    uintptr_t offset = 0;
+    uint32_t flags = MEMSECT_FLAGS_USED | MEMSECT_FLAGS_OBJ;
+
+    if(pObj == NULL)
+    {
+        return;
+    }
+
+    // Only the start of a sector buffer of this pool is taken back
+    offset = (uintptr_t)pObj - MEM_POOL_DATA(p_pool);
+    if(((uintptr_t)pObj < MEM_POOL_DATA(p_pool)) || ((offset % p_pool->Sec_Stride) != 0u) ||\
+        ((offset / p_pool->Sec_Stride) >= __atomic_load_n(&p_pool->Sec_Cnt, __ATOMIC_ACQUIRE)))
+    {
+        return;
+    }
+
+    // Sectors of chains and objects freed already are left alone
+    p_sect = &MEM_POOL_DESC(p_pool)[offset / p_pool->Sec_Stride];
+    if(p_pool->Flags & MEM_POOL_FLAGS_CONCURRENT)
+    {
+        if(!__atomic_compare_exchange_n(&p_sect->Flags, &flags, MEMSECT_FLAGS_NONE, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+        {
+            return;
+        }
+    }
+    else
+    {
+        if(p_sect->Flags != flags)
+        {
+            return;
+        }
+        p_sect->Flags = MEMSECT_FLAGS_NONE;
+    }
+    mempool_pushFree(p_pool, p_sect, p_sect, 1uL);
+}
+
+/* **************************************************************************
+ * Function turns a sector handle into a number valid in every mapping of the
+ * pool, for passing a chain to another process sharing it
+ *  pMem        ->  Pointer to the top of Heap memory the sector belongs to
+ *  pMemSect    ->  Pointer to memory sector start descriptor
+ * Returns the sector number, zero for NULL
+ ************************************************************************** */
+unsigned long mempool_sectHandle(const void *const pMem, const void *const pMemSect)
+{
+    (void)pMem;
+
+    return (pMemSect != NULL) ? ((unsigned long)((t_MemSect *)pMemSect)->Self + 1uL) : 0uL;
+}
+
+/* **************************************************************************
+ * Function turns a sector number of mempool_sectHandle back into a sector
+ * handle valid in the mapping of the pool given
+ *  pMem        ->  Pointer to the top of Heap memory as mapped by the caller
+ *  Handle      ->  Sector number
+ * Returns the Sector Pointer, NULL if the number is out of the pool
+ ************************************************************************** */
+void *mempool_handleSect(const void *const pMem, const unsigned long Handle)
+{
+    struct s_Mem *p_pool = (struct s_Mem *)pMem;
+
+    if((Handle == 0uL) || (Handle > __atomic_load_n(&p_pool->Sec_Cnt, __ATOMIC_ACQUIRE)))
+    {
+        return NULL;
+    }
+
+    return (void *)&MEM_POOL_DESC(p_pool)[Handle - 1uL];
+}
+
+/* **************************************************************************
+ * Function used for reading data from the memory, everytime you read data
+ * the read pointer is incremented
+ *  pMemSect    ->  Pointer to memory sector descriptor to be read from read index
+ *  pTarget     ->  Pointer to target buffer
+ *  TargetSize  ->  Size of the target buffer
+ *  ReadCount   ->  Number of bytes to be read
+ * Returns the number of bytes copied to target buffer, zero if error
+ ************************************************************************** */
+unsigned long mempool_readFromIndex(const void *const pMemSect, void *pTarget,\
+                                        const unsigned long TargetSize, const unsigned long ReadCount)
+{
+    t_MemSect *p_head = (t_MemSect *)pMemSect;
+    t_MemHead *p_state = NULL;
+    t_MemSect *p_mem = NULL;
+    char *p_out = (char *)pTarget;
+    unsigned long read_index = 0;
+    unsigned long sect_buf_size = 0;
+    unsigned long bytes_read = 0;
+    unsigned long read_processed = ReadCount;
+    unsigned long read_count = 0;
+
+    if((p_head == NULL) || (pTarget == NULL))
+    {
+        return 0;
+    }
+    p_state = mempool_sectHead(p_head);
+
+    // Never past the written data nor the target buffer
+    if(read_processed > (p_state->WriteIndex - p_state->ReadIndex))
+    {
+        read_processed = p_state->WriteIndex - p_state->ReadIndex;
+    }
+    if(read_processed > TargetSize)
+    {
+        read_processed = TargetSize;
+    }
+
+    // Resume straight at the sector holding the read index
+    p_mem = mempool_linkSect(p_head, p_state->Read);
+    read_index = p_state->ReadIndex - p_state->ReadBase;
+
+    while(read_count < read_processed)
+    {
+        sect_buf_size = mempool_sectFill(p_mem);
+        if(read_index >= sect_buf_size)
+        {
+            // Sector consumed, reading continues in the concatenated one
+            p_state->ReadBase += sect_buf_size;
+            p_mem = mempool_sectNext(p_mem);
+            p_state->Read = mempool_sectLink(p_head, p_mem);
+            read_index = 0;
+            continue;
+        }
+
+        bytes_read = sect_buf_size - read_index;
+        if(bytes_read > (read_processed - read_count))
+        {
+            bytes_read = read_processed - read_count;
+        }
+
+        memcpy(p_out + read_count, mempool_sectData(p_mem) + read_index, bytes_read);
+        read_index += bytes_read;
+        read_count += bytes_read;
+        p_state->ReadIndex += bytes_read;
+    }
+
+    mempool_statBytes(mempool_sectPool(p_head), 0uL, read_count);
+    if(p_head->Flags & MEMSECT_FLAGS_RECLAIM)
+    {
+        mempool_chainReclaim(p_head);
+    }
+
+    return read_count;
+}
+
+/* **************************************************************************
+ * Function reads entire buffer data of data limited to size of Target Buffer
+ * read pointer index is not incremented while execution data read from Index 0
+ *  pMemSect    ->  Pointer to memory sector descriptor to be read from read index
+ *  pTarget     ->  Pointer to target buffer
+ *  TargetSize  ->  Size of the target buffer
+ * Returns the number of bytes copied to target buffer, zero if error
+ ************************************************************************** */
+unsigned long mempool_readFull(const void *const pMemSect, void *pTarget, const unsigned long TargetSize)
+{
+    void *p_mem = (void *)pMemSect;
+    void *p_read = NULL;
+    void *p_out = pTarget;
+    unsigned long bytes_read = 0;
+    unsigned long sect_buf_size = 0;
+    unsigned long flags = 0;
+    unsigned long data_present = 1;
+    unsigned long read_processed = TargetSize;
+    unsigned long read_count = 0;
+
+    if(read_processed > *((unsigned long *)(((char *)mempool_sectHead(p_mem)) + MEM_POOL_OFFSET(t_MemHead, WriteIndex))))
+    {
+        read_processed = *((unsigned long *)(((char *)mempool_sectHead(p_mem)) + MEM_POOL_OFFSET(t_MemHead, WriteIndex)));
+    }
+
+    if(read_processed == 0)
+    {
+        // No data writted in the memory
+        return 0;
+    }
+
+    if((p_mem != NULL) && (pTarget != NULL))
+    {
+        while(data_present == 1)
+        {
+            flags = *((uint32_t *)(((char *)p_mem) + MEM_POOL_OFFSET(t_MemSect, Flags)));
+            p_read = (void *)mempool_sectData(p_mem);
+            sect_buf_size = mempool_sectFill(p_mem);
+            
+            if(read_processed < sect_buf_size)
+            {
+                bytes_read = read_processed;
+            }
+            else
+            {
+                bytes_read = sect_buf_size;
+            }
+
+            if((read_count + bytes_read) > TargetSize)
+            {
+                // Since target buffer is exhausted
+                break;
+            }
+
+            memcpy(p_out, p_read, bytes_read);
+            read_processed -= bytes_read;
+            read_count += bytes_read;
+            if(flags & MEMSECT_FLAGS_CONCAT)
+            {
+                p_mem = (void *)mempool_sectNext(p_mem);
+            }
+            else
+            {
+                data_present = 0;
+            }
+            if(read_processed == 0)
+            {
+                data_present = 0;
+            }
+            else
+            {
+                p_out = (void *)((uintptr_t)((char *)p_out + bytes_read));
+            }
+        }
+    }
+
+    (void)bytes_read;
+    (void)flags;
+    (void)sect_buf_size;
+    (void)read_processed;
+    if(read_count != 0)
+    {
+        mempool_statBytes(mempool_sectPool(pMemSect), 0uL, read_count);
+    }
+    return read_count;
+}
+
+/* **************************************************************************
+ * Function writes data to allocated buffer or adds data to new buffer allocation
+ *  pMem        ->  Pointer to the memory returned by mempool_init
+ *  pMemSect    ->  Pointer to memory sector descriptor where data is to be written
+ *  pSouce      ->  Pointer to source buffer from where data needs to be read
+ *  SrcSize     ->  Length of the data to be written
+ * Returns number of bytes written to the memory sector.
+ ************************************************************************** */
+unsigned long mempool_writeToIndex(const void *const pMem, const void *const pMemSect,\
+                                    const char *const pSource, const unsigned long SrcSize)
+{
+    return mempool_writeChain(pMem, NULL, pMemSect, pSource, SrcSize);
+}
+
+/* **************************************************************************
+ * Function writes data to the chain growing it with sectors of a pool group,
+ * each added sector is the best fit for the data left to be written but
+ * never smaller than the sector it follows
+ *  pGroup      ->  Pointer to the pool group prepared by mempool_groupInit
+ *  pMemSect    ->  Pointer to memory sector descriptor where data is to be written
+ *  pSouce      ->  Pointer to source buffer from where data needs to be read
+ *  SrcSize     ->  Length of the data to be written
+ * Returns number of bytes written to the memory sector.
+ ************************************************************************** */
+unsigned long mempool_groupWrite(const t_MemGroup *const pGroup, const void *const pMemSect,\
+                                    const char *const pSource, const unsigned long SrcSize)
+{
+    return mempool_writeChain(NULL, pGroup, pMemSect, pSource, SrcSize);
+}
+
+/* **************************************************************************
+ * Function writes data to allocated buffer or adds data to new buffer allocation
+ *  pMem        ->  Pointer to the memory the chain grows from, unused with a group
+ *  pGroup      ->  Pointer to the pool group the chain grows from, NULL for pMem
+ *  pMemSect    ->  Pointer to memory sector descriptor where data is to be written
+ *  pSouce      ->  Pointer to source buffer from where data needs to be read
+ *  SrcSize     ->  Length of the data to be written
+ * Returns number of bytes written to the memory sector.
+ ************************************************************************** */
+static unsigned long mempool_writeChain(const void *const pMem, const t_MemGroup *const pGroup, const void *const pMemSect,\
+                                            const char *const pSource, const unsigned long SrcSize)
+{
+    t_MemSect *p_head = (t_MemSect *)pMemSect;
+    t_MemHead *p_state = NULL;
+    t_MemSect *p_mem = NULL;
+    t_MemSect *p_next = NULL;
+    const char *p_src = pSource;
+    unsigned long write_index = 0;
+    unsigned long sect_buf_size = 0;
+    unsigned long bytes_to_write = 0;
+    unsigned long write_count = 0;
+
+    if((p_head == NULL) || (pSource == NULL) || mempool_chainShared(p_head))
+    {
+        return 0;
+    }
+    p_state = mempool_sectHead(p_head);
+
+    // Resume straight at the sector holding the write index
+    p_mem = mempool_linkSect(p_head, p_state->Write);
+    write_index = p_state->WriteIndex - p_state->WriteBase;
+
+    while(write_count < SrcSize)
+    {
+        sect_buf_size = mempool_sectSize(p_mem);
+        if(write_index >= sect_buf_size)
+        {
+            p_next = mempool_sectExtend(pMem, pGroup, p_head, p_mem, SrcSize - write_count);
+            if(p_next == NULL)
+            {
+                // Memory all consumed
+                break;
+            }
+            // Sector filled, write continues in the concatenated one
+            p_state->WriteBase += sect_buf_size;
+            p_state->Write = mempool_sectLink(p_head, p_next);
+            p_mem = p_next;
+            write_index = 0;
+            continue;
+        }
+
+        bytes_to_write = sect_buf_size - write_index;
+        if(bytes_to_write > (SrcSize - write_count))
+        {
+            bytes_to_write = SrcSize - write_count;
+        }
+
+        memcpy(mempool_sectData(p_mem) + write_index, p_src, bytes_to_write);
+        p_src += bytes_to_write;
+        write_index += bytes_to_write;
+        write_count += bytes_to_write;
+        p_state->WriteIndex += bytes_to_write;
+    }
+
+    mempool_statBytes(mempool_sectPool(p_head), write_count, 0uL);
+    return write_count;
+}
+
+/* **************************************************************************
+ * Function resets write and read pointers of the allocated memory, a chain
+ * with clones is left as it is until they are freed
+ *  pMemSect    ->  Pointer to memory sectors start descriptor who needs to be resetted
+ * Returns none.
+ ************************************************************************** */
+void mempool_resetMemory(const void *const pMemSect)
+{
+    char *p_state = (char *)mempool_sectHead(pMemSect);
+
+    if(__atomic_load_n(&((t_MemSect *)pMemSect)->Flags, __ATOMIC_RELAXED) & MEMSECT_FLAGS_REFS)
+    {
+        // Clones still read the data, it is not to be overwritten
+        return;
+    }
+    mempool_gapClear((t_MemSect *)pMemSect);
+    *((unsigned long *)(p_state + MEM_POOL_OFFSET(t_MemHead, ReadIndex))) = 0uL;
+    *((unsigned long *)(p_state + MEM_POOL_OFFSET(t_MemHead, WriteIndex))) = 0uL;
+    *((uint32_t *)(p_state + MEM_POOL_OFFSET(t_MemHead, Write))) = MEM_POOL_LINK(0u, ((t_MemSect *)pMemSect)->Self);
+    *((unsigned long *)(p_state + MEM_POOL_OFFSET(t_MemHead, WriteBase))) = 0uL;
+    *((uint32_t *)(p_state + MEM_POOL_OFFSET(t_MemHead, Read))) = MEM_POOL_LINK(0u, ((t_MemSect *)pMemSect)->Self);
+    *((unsigned long *)(p_state + MEM_POOL_OFFSET(t_MemHead, ReadBase))) = 0uL;
+}
+
+/* **************************************************************************
+ * Function resets write and read pointers of the allocated memory and returns
+ * every concatenated sector to the pool, leaving only the head sector. A chain
+ * with clones is left as it is, a clone drops its share of the data.
+ *  pMemSect    ->  Pointer to memory sectors start descriptor who needs to be resetted
+ * Returns none.
+ ************************************************************************** */
+void mempool_resetTrim(const void *const pMemSect)
+{
+    t_MemSect *p_head = (t_MemSect *)pMemSect;
+
+    if(__atomic_load_n(&p_head->Flags, __ATOMIC_RELAXED) & MEMSECT_FLAGS_REFS)
+    {
+        // Clones still read the data, it is not to be released
+        return;
+    }
+    if(p_head->Flags & MEMSECT_FLAGS_CONCAT)
+    {
+        mempool_chainRelease(mempool_sectNext(p_head), NULL);
+        p_head->Flags &= ~MEMSECT_FLAGS_CONCAT;
+        p_head->Concat = 0u;
+    }
+    // A clone gives up the shared data and becomes a chain of its own
+    p_head->Flags &= ~MEMSECT_FLAGS_CLONE;
+    p_head->Gap = 0u;
+    mempool_resetMemory(pMemSect);
+}
+
+/* **************************************************************************
+ * Function switches a chain to reclaim mode, every read then returns sectors
+ * fully read back to the pool so a long lived chain only holds unread data,
+ * the head sector and at most the sector being read
+ *  pMemSect    ->  Pointer to memory sector start descriptor
+ *  Enable      ->  Non zero to release consumed sectors while reading
+ * Returns none.
+ ************************************************************************** */
+void mempool_reclaimMode(const void *const pMemSect, const unsigned long Enable)
+{
+    t_MemSect *p_head = (t_MemSect *)pMemSect;
+
+    // Clones freed by other threads drop references in the same flags
+    if(Enable != 0)
+    {
+        __atomic_or_fetch(&p_head->Flags, MEMSECT_FLAGS_RECLAIM, __ATOMIC_RELAXED);
+        mempool_chainReclaim(p_head);
+    }
+    else
+    {
+        __atomic_and_fetch(&p_head->Flags, ~MEMSECT_FLAGS_RECLAIM, __ATOMIC_RELAXED);
+    }
+}
+
+/* **************************************************************************
+ * Function lets you know how much data can be extracted during next read cycle
+ *  pMemSect    ->  Pointer to memory sector start descriptor
+ * Returns number of bytes can be read by next read instruction.
+ ************************************************************************** */
+unsigned long mempool_availableData(const void *const pMemSect)
+{
+    return *((unsigned long *)(((char *)mempool_sectHead(pMemSect)) + MEM_POOL_OFFSET(t_MemHead, WriteIndex))) -\
+                *((unsigned long *)(((char *)mempool_sectHead(pMemSect)) + MEM_POOL_OFFSET(t_MemHead, ReadIndex)));
+}
+
+/* **************************************************************************
+ * Function counts number of used memory sectors, sectors held by a per thread
+ * cache count as used until they are flushed back to the pool
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_init
+ * Returns currently allocated sectors.
+ ************************************************************************** */
+unsigned long mempool_sectUsed(const void *const pMem)
+{
+    return __atomic_load_n(&((struct s_Mem *)pMem)->Sect_Used, __ATOMIC_RELAXED);
+}
+
+/* **************************************************************************
+ * Function takes a snapshot of the pool counters kept by the hot paths, on a
+ * concurrent pool each counter is exact but they are not read at one instant
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_init
+ *  pStats      ->  Pointer to the structure receiving the counters
+ * Returns none.
+ ************************************************************************** */
+void mempool_stats(const void *const pMem, t_MemStats *const pStats)
+{
+    struct s_Mem *p_pool = (struct s_Mem *)pMem;
+    unsigned long index = 0;
+
+    pStats->Sect_Cnt = __atomic_load_n(&p_pool->Sec_Cnt, __ATOMIC_RELAXED);
+    pStats->Sect_Size = p_pool->Sec_Size;
+    pStats->Sect_Used = __atomic_load_n(&p_pool->Sect_Used, __ATOMIC_RELAXED);
+    pStats->Sect_High = __atomic_load_n(&p_pool->Sect_High, __ATOMIC_RELAXED);
+    pStats->Alloc_Fail = __atomic_load_n(&p_pool->Alloc_Fail, __ATOMIC_RELAXED);
+    pStats->Alloc_Extend = __atomic_load_n(&p_pool->Alloc_Extend, __ATOMIC_RELAXED);
+    pStats->Bytes_Written = 0uL;
+    pStats->Bytes_Read = 0uL;
+    for(index = 0; index < MEM_POOL_STAT_STRIPES; index++)
+    {
+        pStats->Bytes_Written += __atomic_load_n(&p_pool->Bytes[index].Bytes_Written, __ATOMIC_RELAXED);
+        pStats->Bytes_Read += __atomic_load_n(&p_pool->Bytes[index].Bytes_Read, __ATOMIC_RELAXED);
+    }
+    for(index = 0; index < MEM_POOL_HIST_BINS; index++)
+    {
+        pStats->Chain_Hist[index] = __atomic_load_n(&p_pool->Chain_Hist[index], __ATOMIC_RELAXED);
+    }
 }
 
 /* **************************************************************************
  * Function responds with percentage of memory used out of allocated on RAM
- *  pMem        ->  Pointer to the top of Heap memory fetched using MEM_POOL_ADDR(Name) macro
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_init
  * Returns percentage of active usable memory (double type)
  ************************************************************************** */
-double mempool_activeSection(const void *const pMem)
+double mempool_activeSection(const void *const pMem)
+{
+    unsigned long total_size = ((struct s_Mem *)pMem)->Total_Memory;
+    unsigned long sect_cnt = __atomic_load_n(&((struct s_Mem *)pMem)->Sec_Cnt, __ATOMIC_RELAXED);
+    unsigned long sect_size = ((struct s_Mem *)pMem)->Sec_Size;
+    return (((((double)(sect_cnt * sect_size)) * 100.0) / (double)total_size));
+}
+
+/* **************************************************************************
+ * Function prepares a per thread sector cache in front of a pool
+ *  pCache      ->  Pointer to the cache, usually a thread local variable
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_init
+ *  CacheSize   ->  Sectors kept before spilling back to the pool, up to MEM_POOL_CACHE_MAX
+ *  BatchSize   ->  Sectors moved from or to the pool at once, up to CacheSize
+ * Returns none.
+ ************************************************************************** */
+void mempool_cacheInit(t_MemCache *const pCache, const void *const pMem, const unsigned long CacheSize, const unsigned long BatchSize)
+{
+    pCache->pMem = (void *)pMem;
+    pCache->Size = (CacheSize > MEM_POOL_CACHE_MAX) ? MEM_POOL_CACHE_MAX : CacheSize;
+    if(pCache->Size == 0)
+    {
+        pCache->Size = 1;
+    }
+    pCache->Batch = ((BatchSize == 0) || (BatchSize > pCache->Size)) ? pCache->Size : BatchSize;
+    pCache->Count = 0;
+}
+
+/* **************************************************************************
+ * Function allocates a sector from the per thread cache, refilling the cache
+ * with a batch of sectors from the pool when it runs dry
+ *  pCache      ->  Pointer to the cache prepared by mempool_cacheInit
+ * Returns the Sector Pointer if available else returns NULL
+ ************************************************************************** */
+void *mempool_cacheAlloc(t_MemCache *const pCache)
+{
+    t_MemSect *p_sect = NULL;
+
+    if(pCache->Count == 0)
+    {
+        pCache->Count = mempool_popFree((struct s_Mem *)pCache->pMem, (t_MemSect **)pCache->pSect, pCache->Batch);
+    }
+
+    if(pCache->Count != 0)
+    {
+        p_sect = (t_MemSect *)pCache->pSect[--pCache->Count];
+        mempool_sectClaim(p_sect);
+    }
+
+    return (void *)p_sect;
+}
+
+/* **************************************************************************
+ * Function frees the allocated sector chain into the per thread cache, a batch
+ * of sectors is returned to the pool whenever the cache overflows
+ *  pCache      ->  Pointer to the cache prepared by mempool_cacheInit
+ *  pMemSect    ->  Pointer to memory sector descriptor which needs to be marked
+ *                  free for the future use.
+ * Returns none.
+ ************************************************************************** */
+void mempool_cacheFree(t_MemCache *const pCache, const void *const pMemSect)
+{
+    unsigned long flags = MEMSECT_FLAGS_NONE;
+    unsigned long index = 0;
+    t_MemSect *p_mem = (t_MemSect *)pMemSect;
+    t_MemSect *p_concat = NULL;
+    t_MemSect **p_cached = (t_MemSect **)pCache->pSect;
+    struct s_Mem *p_pool = NULL;
+    unsigned long released = 0;
+
+    while(p_mem != NULL)
+    {
+        p_pool = mempool_sectPool(p_mem);
+        // Link resolved first, the free list reuses it once the sector is released
+        p_concat = mempool_sectNext(p_mem);
+        flags = mempool_sectRelease(p_pool, p_mem);
+        if(flags == MEMSECT_FLAGS_NONE)
+        {
+            // Sector is already free
+            break;
+        }
+        if(flags & MEMSECT_FLAGS_REFS)
+        {
+            // Another chain still reads this sector and every one after it
+            break;
+        }
+
+        if((void *)p_pool != pCache->pMem)
+        {
+            // Sector of another pool goes straight home
+            mempool_pushFree(p_pool, p_mem, p_mem, 1uL);
+        }
+        else
+        {
+            if(pCache->Count >= pCache->Size)
+            {
+                // Cache overflow, spill the oldest batch back to the pool
+                for(index = 1; index < pCache->Batch; index++)
+                {
+                    __atomic_store_n(&p_cached[index - 1]->Concat, MEM_POOL_LINK(0u, p_cached[index]->Self), __ATOMIC_RELAXED);
+                }
+                mempool_pushFree((struct s_Mem *)pCache->pMem, p_cached[0], p_cached[pCache->Batch - 1], pCache->Batch);
+                pCache->Count -= pCache->Batch;
+                memmove(&p_cached[0], &p_cached[pCache->Batch], pCache->Count * sizeof(p_cached[0]));
+            }
+            p_cached[pCache->Count++] = p_mem;
+        }
+        released++;
+        p_mem = (flags & MEMSECT_FLAGS_CONCAT) ? p_concat : NULL;
+    }
+
+    if(released != 0)
+    {
+        mempool_statChain(mempool_sectPool((t_MemSect *)pMemSect), released);
+    }
+}
+
+/* **************************************************************************
+ * Function returns every cached sector to the pool, call before the owning
+ * thread exits or when the pool counters have to be exact
+ *  pCache      ->  Pointer to the cache prepared by mempool_cacheInit
+ * Returns none.
+ ************************************************************************** */
+void mempool_cacheFlush(t_MemCache *const pCache)
+{
+    unsigned long index = 0;
+    t_MemSect **p_cached = (t_MemSect **)pCache->pSect;
+
+    if(pCache->Count != 0)
+    {
+        for(index = 1; index < pCache->Count; index++)
+        {
+            __atomic_store_n(&p_cached[index - 1]->Concat, MEM_POOL_LINK(0u, p_cached[index]->Self), __ATOMIC_RELAXED);
+        }
+        mempool_pushFree((struct s_Mem *)pCache->pMem, p_cached[0], p_cached[pCache->Count - 1], pCache->Count);
+        pCache->Count = 0;
+    }
+}
+
+/* **************************************************************************
+ * Function groups pools of different sector sizes, allocations are routed to
+ * the smallest sector size class fitting the request
+ *  pGroup      ->  Pointer to the pool group to be prepared
+ *  ppMem       ->  Array of initialized pools, any order
+ *  PoolCnt     ->  Number of pools in the array, up to MEM_POOL_GROUP_MAX
+ * Returns number of pools taken in the group.
+ ************************************************************************** */
+unsigned long mempool_groupInit(t_MemGroup *const pGroup, void *const *const ppMem, const unsigned long PoolCnt)
+{
+    unsigned long index = 0;
+    unsigned long slot = 0;
+    void *p_mem = NULL;
+
+    pGroup->Pool_Cnt = 0;
+    for(index = 0; (index < PoolCnt) && (index < MEM_POOL_GROUP_MAX); index++)
+    {
+        // Insertion keeps the classes sorted by ascending sector size
+        p_mem = ppMem[index];
+        for(slot = pGroup->Pool_Cnt; (slot > 0) && (((struct s_Mem *)pGroup->pMem[slot - 1])->Sec_Size > ((struct s_Mem *)p_mem)->Sec_Size); slot--)
+        {
+            pGroup->pMem[slot] = pGroup->pMem[slot - 1];
+        }
+        pGroup->pMem[slot] = p_mem;
+        pGroup->Pool_Cnt++;
+    }
+
+    return pGroup->Pool_Cnt;
+}
+
+/* **************************************************************************
+ * Function allocates a sector from the best fitting size class of the group,
+ * a larger class is used when the best one is exhausted and a smaller one
+ * when all larger classes are exhausted as well
+ *  pGroup      ->  Pointer to the pool group prepared by mempool_groupInit
+ *  Size        ->  Number of bytes expected to be stored
+ * Returns the Sector Pointer if available else returns NULL
+ ************************************************************************** */
+void *mempool_groupAlloc(const t_MemGroup *const pGroup, const unsigned long Size)
+{
+    unsigned long best = 0;
+    unsigned long index = 0;
+    void *p_sect = NULL;
+
+    if(pGroup->Pool_Cnt == 0)
+    {
+        return NULL;
+    }
+
+    while((best < (pGroup->Pool_Cnt - 1)) && (((struct s_Mem *)pGroup->pMem[best])->Sec_Size < Size))
+    {
+        best++;
+    }
+
+    for(index = best; (index < pGroup->Pool_Cnt) && (p_sect == NULL); index++)
+    {
+        p_sect = mempool_alloc(pGroup->pMem[index]);
+    }
+    for(index = best; (index > 0) && (p_sect == NULL); index--)
+    {
+        p_sect = mempool_alloc(pGroup->pMem[index - 1]);
+    }
+
+    return p_sect;
+}
+
+#if defined(MEM_POOL_POSIX)
+/* **************************************************************************
+ * Function describes the unread data of the chain as a scatter/gather list
+ * without copying, the read index is not moved
+ *  pMemSect    ->  Pointer to memory sector start descriptor
+ *  pIov        ->  Array of iovec to be filled, ready for writev or sendmsg
+ *  IovCnt      ->  Number of entries in the array
+ * Returns number of iovec entries filled, zero if no data to be read
+ ************************************************************************** */
+unsigned long mempool_readIovec(const void *const pMemSect, struct iovec *const pIov, const unsigned long IovCnt)
+{
+    t_MemSect *p_head = (t_MemSect *)pMemSect;
+    t_MemHead *p_state = NULL;
+    t_MemSect *p_mem = NULL;
+    unsigned long read_index = 0;
+    unsigned long sect_buf_size = 0;
+    unsigned long bytes_read = 0;
+    unsigned long available = 0;
+    unsigned long iov_cnt = 0;
+
+    if((p_head == NULL) || (pIov == NULL))
+    {
+        return 0;
+    }
+    p_state = mempool_sectHead(p_head);
+
+    p_mem = mempool_linkSect(p_head, p_state->Read);
+    read_index = p_state->ReadIndex - p_state->ReadBase;
+    available = p_state->WriteIndex - p_state->ReadIndex;
+
+    while((available > 0) && (iov_cnt < IovCnt))
+    {
+        sect_buf_size = mempool_sectFill(p_mem);
+        if(read_index >= sect_buf_size)
+        {
+            p_mem = mempool_sectNext(p_mem);
+            read_index = 0;
+            continue;
+        }
+
+        bytes_read = sect_buf_size - read_index;
+        if(bytes_read > available)
+        {
+            bytes_read = available;
+        }
+        pIov[iov_cnt].iov_base = mempool_sectData(p_mem) + read_index;
+        pIov[iov_cnt].iov_len = bytes_read;
+        iov_cnt++;
+        available -= bytes_read;
+        read_index += bytes_read;
+    }
+
+    return iov_cnt;
+}
+
+/* **************************************************************************
+ * Function moves the read index forward after data has been used in place,
+ * for example after a partial writev of the mempool_readIovec list
+ *  pMemSect    ->  Pointer to memory sector start descriptor
+ *  Count       ->  Number of bytes consumed
+ * Returns number of bytes the read index moved, limited to the unread data
+ ************************************************************************** */
+unsigned long mempool_readConsume(const void *const pMemSect, const unsigned long Count)
+{
+    t_MemSect *p_head = (t_MemSect *)pMemSect;
+    t_MemHead *p_state = NULL;
+    unsigned long consumed = Count;
+
+    if(p_head == NULL)
+    {
+        return 0;
+    }
+    p_state = mempool_sectHead(p_head);
+
+    if(consumed > (p_state->WriteIndex - p_state->ReadIndex))
+    {
+        consumed = p_state->WriteIndex - p_state->ReadIndex;
+    }
+    p_state->ReadIndex += consumed;
+    mempool_headSeek(p_head, &p_state->Read, &p_state->ReadBase, p_state->ReadIndex);
+    mempool_statBytes(mempool_sectPool(p_head), 0uL, consumed);
+    if(p_head->Flags & MEMSECT_FLAGS_RECLAIM)
+    {
+        mempool_chainReclaim(p_head);
+    }
+
+    return consumed;
+}
+
+/* **************************************************************************
+ * Function describes free space after the write index as a scatter/gather
+ * list, sectors are allocated and concatenated until Size bytes are covered
+ * or the pool is exhausted. The write index is not moved.
+ *  pMem        ->  Pointer to the memory returned by mempool_init
+ *  pMemSect    ->  Pointer to memory sector start descriptor
+ *  pIov        ->  Array of iovec to be filled, ready for readv or recvmsg
+ *  IovCnt      ->  Number of entries in the array
+ *  Size        ->  Number of bytes of free space wanted
+ * Returns number of iovec entries filled, zero if no space available
+ ************************************************************************** */
+unsigned long mempool_writeIovec(const void *const pMem, const void *const pMemSect, struct iovec *const pIov,\
+                                    const unsigned long IovCnt, const unsigned long Size)
+{
+    t_MemSect *p_head = (t_MemSect *)pMemSect;
+    t_MemHead *p_state = NULL;
+    t_MemSect *p_mem = NULL;
+    unsigned long write_index = 0;
+    unsigned long sect_buf_size = 0;
+    unsigned long bytes_to_write = 0;
+    unsigned long wanted = Size;
+    unsigned long iov_cnt = 0;
+
+    if((p_head == NULL) || (pIov == NULL) || mempool_chainShared(p_head))
+    {
+        return 0;
+    }
+    p_state = mempool_sectHead(p_head);
+
+    p_mem = mempool_linkSect(p_head, p_state->Write);
+    write_index = p_state->WriteIndex - p_state->WriteBase;
+
+    while((wanted > 0) && (iov_cnt < IovCnt))
+    {
+        sect_buf_size = mempool_sectSize(p_mem);
+        if(write_index >= sect_buf_size)
+        {
+            p_mem = mempool_sectExtend(pMem, NULL, p_head, p_mem, wanted);
+            if(p_mem == NULL)
+            {
+                // Memory all consumed
+                break;
+            }
+            write_index = 0;
+            continue;
+        }
+
+        bytes_to_write = sect_buf_size - write_index;
+        if(bytes_to_write > wanted)
+        {
+            bytes_to_write = wanted;
+        }
+        pIov[iov_cnt].iov_base = mempool_sectData(p_mem) + write_index;
+        pIov[iov_cnt].iov_len = bytes_to_write;
+        iov_cnt++;
+        wanted -= bytes_to_write;
+        write_index += bytes_to_write;
+    }
+
+    return iov_cnt;
+}
+#endif
+
+/* **************************************************************************
+ * Function reserves contiguous free space at the write index for a producer
+ * encoding in place, a sector is allocated and concatenated when the one at
+ * the write index is full. Data becomes readable with mempool_writeCommit.
+ *  pMem        ->  Pointer to the memory returned by mempool_init
+ *  pMemSect    ->  Pointer to memory sector start descriptor
+ *  pLength     ->  Receives the number of contiguous bytes reserved
+ * Returns pointer to the reserved space, NULL if the pool is exhausted
+ ************************************************************************** */
+void *mempool_writeReserve(const void *const pMem, const void *const pMemSect, unsigned long *const pLength)
+{
+    t_MemSect *p_head = (t_MemSect *)pMemSect;
+    t_MemHead *p_state = NULL;
+    t_MemSect *p_mem = NULL;
+    unsigned long write_index = 0;
+
+    if(pLength != NULL)
+    {
+        *pLength = 0;
+    }
+    if((p_head == NULL) || (pLength == NULL) || mempool_chainShared(p_head))
+    {
+        return NULL;
+    }
+    p_state = mempool_sectHead(p_head);
+
+    p_mem = mempool_linkSect(p_head, p_state->Write);
+    write_index = p_state->WriteIndex - p_state->WriteBase;
+    if(write_index >= mempool_sectSize(p_mem))
+    {
+        p_mem = mempool_sectExtend(pMem, NULL, p_head, p_mem, 1uL);
+        if(p_mem == NULL)
+        {
+            // Memory all consumed
+            return NULL;
+        }
+        write_index = 0;
+    }
+
+    *pLength = mempool_sectSize(p_mem) - write_index;
+    return (void *)(mempool_sectData(p_mem) + write_index);
+}
+
+/* **************************************************************************
+ * Function moves the write index forward after data has been produced in
+ * place, for example after readv into the mempool_writeIovec list
+ *  pMemSect    ->  Pointer to memory sector start descriptor
+ *  Count       ->  Number of bytes produced
+ * Returns number of bytes the write index moved, limited to the sectors
+ * already concatenated to the chain
+ ************************************************************************** */
+unsigned long mempool_writeCommit(const void *const pMemSect, const unsigned long Count)
+{
+    t_MemSect *p_head = (t_MemSect *)pMemSect;
+    t_MemHead *p_state = NULL;
+    t_MemSect *p_mem = NULL;
+    unsigned long write_index = 0;
+    unsigned long sect_buf_size = 0;
+    unsigned long committed = 0;
+
+    if((p_head == NULL) || mempool_chainShared(p_head))
+    {
+        return 0;
+    }
+    p_state = mempool_sectHead(p_head);
+
+    // Room left in the chain from the write index on
+    p_mem = mempool_linkSect(p_head, p_state->Write);
+    write_index = p_state->WriteIndex - p_state->WriteBase;
+    while(committed < Count)
+    {
+        sect_buf_size = mempool_sectSize(p_mem);
+        committed += sect_buf_size - write_index;
+        if(!(p_mem->Flags & MEMSECT_FLAGS_CONCAT))
+        {
+            break;
+        }
+        p_mem = mempool_sectNext(p_mem);
+        write_index = 0;
+    }
+    if(committed > Count)
+    {
+        committed = Count;
+    }
+
+    p_state->WriteIndex += committed;
+    mempool_headSeek(p_head, &p_state->Write, &p_state->WriteBase, p_state->WriteIndex);
+    mempool_statBytes(mempool_sectPool(p_head), committed, 0uL);
+
+    return committed;
+}
+
+/* **************************************************************************
+ * Function turns an allocated sector chain into a byte pipe between exactly
+ * one producer thread and one consumer thread, neither side takes a lock.
+ * The pool needs MEM_POOL_FLAGS_CONCURRENT when other threads use it as well.
+ * Chain is released with mempool_free on pHead once both sides are done.
+ *  pStream     ->  Pointer to the stream to be prepared
+ *  pMem        ->  Pointer to the memory the producer grows the chain from
+ *  pMemSect    ->  Pointer to memory sector start descriptor, data already
+ *                  written and not read is carried over
+ * Returns none.
+ ************************************************************************** */
+void mempool_streamInit(t_MemStream *const pStream, const void *const pMem, const void *const pMemSect)
+{
+    t_MemSect *p_head = (t_MemSect *)pMemSect;
+    t_MemHead *p_state = mempool_sectHead(p_head);
+
+    pStream->pMem = (void *)pMem;
+    pStream->pWrite = mempool_linkSect(p_head, p_state->Write);
+    pStream->WriteBase = p_state->WriteBase;
+    pStream->pHead = p_head;
+    pStream->pRead = mempool_linkSect(p_head, p_state->Read);
+    pStream->ReadBase = p_state->ReadBase;
+    pStream->Reclaim = 0uL;
+    __atomic_store_n(&pStream->ReadIndex, p_state->ReadIndex, __ATOMIC_RELAXED);
+    __atomic_store_n(&pStream->WriteIndex, p_state->WriteIndex, __ATOMIC_RELEASE);
+}
+
+/* **************************************************************************
+ * Function appends data to the stream, producer thread only. A sector is
+ * concatenated before the write index passing into it is published, so the
+ * consumer never follows a link that is not set yet.
+ *  pStream     ->  Pointer to the stream prepared by mempool_streamInit
+ *  pSource     ->  Pointer to source buffer from where data needs to be read
+ *  SrcSize     ->  Length of the data to be written
+ * Returns number of bytes written, less than SrcSize if the pool is exhausted
+ ************************************************************************** */
+unsigned long mempool_streamWrite(t_MemStream *const pStream, const char *const pSource, const unsigned long SrcSize)
+{
+    t_MemSect *p_mem = pStream->pWrite;
+    t_MemSect *p_next = NULL;
+    const char *p_src = pSource;
+    unsigned long write_index = __atomic_load_n(&pStream->WriteIndex, __ATOMIC_RELAXED);
+    unsigned long sect_index = write_index - pStream->WriteBase;
+    unsigned long sect_buf_size = 0;
+    unsigned long bytes_to_write = 0;
+    unsigned long write_count = 0;
+
+    if(pSource == NULL)
+    {
+        return 0;
+    }
+
+    while(write_count < SrcSize)
+    {
+        sect_buf_size = mempool_sectSize(p_mem);
+        if(sect_index >= sect_buf_size)
+        {
+            p_next = mempool_sectExtend(pStream->pMem, NULL, NULL, p_mem, SrcSize - write_count);
+            if(p_next == NULL)
+            {
+                // Memory all consumed
+                break;
+            }
+            pStream->WriteBase += sect_buf_size;
+            pStream->pWrite = p_mem = p_next;
+            sect_index = 0;
+            continue;
+        }
+
+        bytes_to_write = sect_buf_size - sect_index;
+        if(bytes_to_write > (SrcSize - write_count))
+        {
+            bytes_to_write = SrcSize - write_count;
+        }
+
+        memcpy(mempool_sectData(p_mem) + sect_index, p_src, bytes_to_write);
+        p_src += bytes_to_write;
+        sect_index += bytes_to_write;
+        write_count += bytes_to_write;
+        write_index += bytes_to_write;
+        // Data and links become visible to the consumer together with the index
+        __atomic_store_n(&pStream->WriteIndex, write_index, __ATOMIC_RELEASE);
+    }
+
+    mempool_statBytes((struct s_Mem *)pStream->pMem, write_count, 0uL);
+#if defined(MEM_POOL_POSIX)
+    if((write_count != 0) && (((struct s_Mem *)pStream->pMem)->Flags & MEM_POOL_FLAGS_CONCURRENT))
+    {
+        mempool_notify((struct s_Mem *)pStream->pMem, MEM_POOL_WAIT_DATA_ALL, MEM_POOL_ARMED_DATA);
+    }
+#endif
+    return write_count;
+}
+
+/* **************************************************************************
+ * Function takes data out of the stream, consumer thread only. The consumer
+ * never reads the flags of the sector the producer is filling, it follows
+ * the concatenation link only when published data lies beyond the current sector.
+ *  pStream     ->  Pointer to the stream prepared by mempool_streamInit
+ *  pTarget     ->  Pointer to target buffer
+ *  TargetSize  ->  Size of the target buffer
+ * Returns number of bytes copied to target buffer, zero if no data available
+ ************************************************************************** */
+unsigned long mempool_streamRead(t_MemStream *const pStream, void *pTarget, const unsigned long TargetSize)
+{
+    t_MemSect *p_mem = pStream->pRead;
+    char *p_out = (char *)pTarget;
+    unsigned long read_index = __atomic_load_n(&pStream->ReadIndex, __ATOMIC_RELAXED);
+    unsigned long write_index = __atomic_load_n(&pStream->WriteIndex, __ATOMIC_ACQUIRE);
+    unsigned long sect_index = read_index - pStream->ReadBase;
+    unsigned long sect_buf_size = 0;
+    unsigned long bytes_read = 0;
+    unsigned long read_processed = write_index - read_index;
+    unsigned long read_count = 0;
+
+    if(pTarget == NULL)
+    {
+        return 0;
+    }
+
+    if(read_processed > TargetSize)
+    {
+        read_processed = TargetSize;
+    }
+
+    while(read_count < read_processed)
+    {
+        sect_buf_size = mempool_sectSize(p_mem);
+        if(sect_index >= sect_buf_size)
+        {
+            pStream->ReadBase += sect_buf_size;
+            pStream->pRead = p_mem = mempool_sectNext(p_mem);
+            sect_index = 0;
+            if(pStream->Reclaim != 0)
+            {
+                // Producer is past the consumed sectors, they go back to the pool
+                mempool_chainRelease(pStream->pHead, p_mem);
+                pStream->pHead = p_mem;
+            }
+            continue;
+        }
+
+        bytes_read = sect_buf_size - sect_index;
+        if(bytes_read > (read_processed - read_count))
+        {
+            bytes_read = read_processed - read_count;
+        }
+
+        memcpy(p_out + read_count, mempool_sectData(p_mem) + sect_index, bytes_read);
+        sect_index += bytes_read;
+        read_count += bytes_read;
+    }
+
+    __atomic_store_n(&pStream->ReadIndex, read_index + read_count, __ATOMIC_RELEASE);
+    mempool_statBytes((struct s_Mem *)pStream->pMem, 0uL, read_count);
+    return read_count;
+}
+
+/* **************************************************************************
+ * Function lets the consumer return sectors it has fully read to the pool, the
+ * first sector of the chain then moves along and is found in pHead. The pool
+ * needs MEM_POOL_FLAGS_CONCURRENT as producer and consumer both touch its
+ * free list, on other pools reclaim stays off.
+ *  pStream     ->  Pointer to the stream prepared by mempool_streamInit
+ *  Enable      ->  Non zero to release consumed sectors while reading
+ * Returns non zero if reclaim is on, zero when refused for the pool.
+ ************************************************************************** */
+unsigned long mempool_streamReclaim(t_MemStream *const pStream, const unsigned long Enable)
+{
+    // Consumer frees while the producer allocates, only the lock-free list takes both
+    pStream->Reclaim = (((struct s_Mem *)pStream->pMem)->Flags & MEM_POOL_FLAGS_CONCURRENT) ? Enable : 0uL;
+
+    return pStream->Reclaim;
+}
+
+/* **************************************************************************
+ * Function lets the consumer know how much data the producer published
+ *  pStream     ->  Pointer to the stream prepared by mempool_streamInit
+ * Returns number of bytes can be read by next mempool_streamRead.
+ ************************************************************************** */
+unsigned long mempool_streamAvailable(const t_MemStream *const pStream)
+{
+    return __atomic_load_n(&pStream->WriteIndex, __ATOMIC_ACQUIRE) - __atomic_load_n(&pStream->ReadIndex, __ATOMIC_RELAXED);
+}
+
+/* **************************************************************************
+ * Function appends a record to the chain, the length goes first as a varint
+ * of seven bits per byte followed by the data. A record is stored whole or
+ * not at all.
+ *  pMem        ->  Pointer to the memory returned by mempool_init
+ *  pMemSect    ->  Pointer to memory sector start descriptor
+ *  pSource     ->  Pointer to the record data
+ *  SrcSize     ->  Length of the record data
+ * Returns number of bytes stored including the length, zero if the pool is
+ * exhausted
+ ************************************************************************** */
+unsigned long mempool_recordWrite(const void *const pMem, const void *const pMemSect, const void *const pSource,\
+                                    const unsigned long SrcSize)
+{
+    t_MemSect *p_head = (t_MemSect *)pMemSect;
+    t_MemHead *p_state = NULL;
+    unsigned char prefix[MEM_POOL_VARINT_MAX];
+    unsigned long prefix_len = 0;
+    unsigned long length = SrcSize;
+    unsigned long write_index = 0;
+    unsigned long write_base = 0;
+    uint32_t write = 0;
+    t_MemSect *p_tail = NULL;
+
+    if((p_head == NULL) || ((pSource == NULL) && (SrcSize != 0)))
+    {
+        return 0;
+    }
+    p_state = mempool_sectHead(p_head);
+
+    do
+    {
+        prefix[prefix_len++] = (unsigned char)((length & 0x7FuL) | ((length > 0x7FuL) ? 0x80uL : 0uL));
+        length >>= 7;
+    } while(length != 0);
+
+    write_index = p_state->WriteIndex;
+    write_base = p_state->WriteBase;
+    write = p_state->Write;
+    // Last sector of the chain, anything concatenated after it belongs to this record
+    p_tail = mempool_linkSect(p_head, write);
+    while(p_tail->Flags & MEMSECT_FLAGS_CONCAT)
+    {
+        p_tail = mempool_sectNext(p_tail);
+    }
+    if((mempool_writeChain(pMem, NULL, p_head, (const char *)prefix, prefix_len) != prefix_len) ||\
+        (mempool_writeChain(pMem, NULL, p_head, (const char *)pSource, SrcSize) != SrcSize))
+    {
+        // Pool exhausted, the partial record and the sectors it took are dropped
+        mempool_statBytes(mempool_sectPool(p_head), write_index - p_state->WriteIndex, 0uL);
+        p_state->WriteIndex = write_index;
+        p_state->WriteBase = write_base;
+        p_state->Write = write;
+        if(p_tail->Flags & MEMSECT_FLAGS_CONCAT)
+        {
+            mempool_chainRelease(mempool_sectNext(p_tail), NULL);
+            p_tail->Flags &= ~MEMSECT_FLAGS_CONCAT;
+            p_tail->Concat = 0u;
+        }
+        return 0;
+    }
+
+    return prefix_len + SrcSize;
+}
+
+/* **************************************************************************
+ * Function takes the record at the read index out of the chain
+ *  pMemSect    ->  Pointer to memory sector start descriptor
+ *  pTarget     ->  Pointer to target buffer
+ *  TargetSize  ->  Size of the target buffer
+ *  pLength     ->  Receives the record length, zero if no complete record is
+ *                  written yet, the size needed if it does not fit pTarget
+ * Returns number of bytes the read index moved, length prefix included, so an
+ * empty record gives its prefix size, zero if the record is left in the chain
+ ************************************************************************** */
+unsigned long mempool_recordRead(const void *const pMemSect, void *const pTarget, const unsigned long TargetSize,\
+                                    unsigned long *const pLength)
+{
+    t_MemRecIter iter;
+    const void *p_rec = NULL;
+
+    *pLength = 0;
+    if((pMemSect == NULL) || (pTarget == NULL))
+    {
+        return 0;
+    }
+
+    mempool_recordIterInit(&iter, pMemSect);
+    p_rec = mempool_recordNext(&iter, pTarget, TargetSize, pLength);
+    if((p_rec == NULL) || (*pLength > TargetSize))
+    {
+        return 0;
+    }
+    if(p_rec != pTarget)
+    {
+        memcpy(pTarget, p_rec, *pLength);
+    }
+
+    return mempool_recordConsume(pMemSect, &iter);
+}
+
+/* **************************************************************************
+ * Function starts an iteration over the records between the read and the
+ * write index, the chain is not changed by iterating
+ *  pIter       ->  Pointer to the iterator to be prepared
+ *  pMemSect    ->  Pointer to memory sector start descriptor
+ * Returns none.
+ ************************************************************************** */
+void mempool_recordIterInit(t_MemRecIter *const pIter, const void *const pMemSect)
+{
+    t_MemSect *p_head = (t_MemSect *)pMemSect;
+    t_MemHead *p_state = mempool_sectHead(p_head);
+
+    pIter->pSect = mempool_linkSect(p_head, p_state->Read);
+    pIter->Base = p_state->ReadBase;
+    pIter->Index = p_state->ReadIndex;
+    pIter->End = p_state->WriteIndex;
+}
+
+/* **************************************************************************
+ * Function gives the next record of an iteration, in place when it lies in
+ * one sector, copied to the scratch buffer when it crosses into the next one
+ *  pIter       ->  Pointer to the iterator prepared by mempool_recordIterInit
+ *  pScratch    ->  Buffer for records crossing a sector, may be NULL
+ *  ScratchSize ->  Size of the scratch buffer
+ *  pLength     ->  Receives the record length, zero at the end of the records
+ * Returns pointer to the record, NULL at the end or when a crossing record
+ * does not fit the scratch buffer, *pLength tells the size needed and the
+ * iterator stays on that record
+ ************************************************************************** */
+const void *mempool_recordNext(t_MemRecIter *const pIter, void *const pScratch, const unsigned long ScratchSize,\
+                                    unsigned long *const pLength)
+{
+    t_MemRecIter iter = *pIter;
+    const char *p_rec = NULL;
+    unsigned long length = 0;
+    unsigned long shift = 0;
+    unsigned long sect_index = 0;
+    unsigned long bytes_read = 0;
+    unsigned long read_count = 0;
+    unsigned char byte = 0;
+
+    *pLength = 0;
+
+    // Length prefix, its bytes may cross into the next sector as well
+    do
+    {
+        if((iter.Index >= iter.End) || (shift >= (sizeof(unsigned long) * 8u)))
+        {
+            // No complete record left
+            return NULL;
+        }
+        mempool_cursorSeek(&iter.pSect, &iter.Base, iter.Index);
+        byte = (unsigned char)mempool_sectData(iter.pSect)[iter.Index - iter.Base];
+        iter.Index++;
+        length |= (unsigned long)(byte & 0x7Fu) << shift;
+        shift += 7;
+    } while(byte & 0x80u);
+    if((iter.End - iter.Index) < length)
+    {
+        return NULL;
+    }
+
+    *pLength = length;
+    mempool_cursorSeek(&iter.pSect, &iter.Base, iter.Index);
+    sect_index = iter.Index - iter.Base;
+    if(length <= (mempool_sectFill(iter.pSect) - sect_index))
+    {
+        // Whole record in one sector, handed out where it is
+        p_rec = mempool_sectData(iter.pSect) + sect_index;
+    }
+    else
+    {
+        if((pScratch == NULL) || (length > ScratchSize))
+        {
+            return NULL;
+        }
+        while(read_count < length)
+        {
+            mempool_cursorSeek(&iter.pSect, &iter.Base, iter.Index + read_count);
+            sect_index = (iter.Index + read_count) - iter.Base;
+            bytes_read = mempool_sectFill(iter.pSect) - sect_index;
+            if(bytes_read > (length - read_count))
+            {
+                bytes_read = length - read_count;
+            }
+            memcpy((char *)pScratch + read_count, mempool_sectData(iter.pSect) + sect_index, bytes_read);
+            read_count += bytes_read;
+        }
+        p_rec = (const char *)pScratch;
+    }
+
+    iter.Index += length;
+    *pIter = iter;
+
+    return (const void *)p_rec;
+}
+
+/* **************************************************************************
+ * Function drops every record an iteration has returned, the read index
+ * moves to the iterator. In reclaim mode sectors may go back to the pool,
+ * iterate again from mempool_recordIterInit afterwards.
+ *  pMemSect    ->  Pointer to memory sector start descriptor
+ *  pIter       ->  Pointer to an iterator over the same chain
+ * Returns number of bytes the read index moved.
+ ************************************************************************** */
+unsigned long mempool_recordConsume(const void *const pMemSect, const t_MemRecIter *const pIter)
+{
+    t_MemSect *p_head = (t_MemSect *)pMemSect;
+    t_MemHead *p_state = mempool_sectHead(p_head);
+    unsigned long consumed = 0;
+
+    if((pIter->Index <= p_state->ReadIndex) || (pIter->Index > p_state->WriteIndex))
+    {
+        // Iterator not ahead of the read index of this chain
+        return 0;
+    }
+
+    consumed = pIter->Index - p_state->ReadIndex;
+    p_state->ReadIndex = pIter->Index;
+    mempool_headSeek(p_head, &p_state->Read, &p_state->ReadBase, p_state->ReadIndex);
+    mempool_statBytes(mempool_sectPool(p_head), 0uL, consumed);
+    if(p_head->Flags & MEMSECT_FLAGS_RECLAIM)
+    {
+        mempool_chainReclaim(p_head);
+    }
+
+    return consumed;
+}
+
+/* **************************************************************************
+ * Function copies unread data of one chain to the end of another sector by
+ * sector, the source read index moves over what is copied
+ *  pMem        ->  Pointer to the memory the destination grows from
+ *  pDst        ->  Pointer to the destination start descriptor
+ *  pSrc        ->  Pointer to the source start descriptor
+ *  Count       ->  Number of bytes to be copied, at most the unread data
+ * Returns number of bytes copied, fewer than Count if the pool is exhausted
+ ************************************************************************** */
+static unsigned long mempool_spliceCopy(const void *const pMem, t_MemSect *pDst, t_MemSect *pSrc, const unsigned long Count)
+{
+    t_MemHead *p_state = mempool_sectHead(pSrc);
+    t_MemSect *p_read = NULL;
+    unsigned long read_index = 0;
+    unsigned long bytes_to_copy = 0;
+    unsigned long written = 0;
+    unsigned long copied = 0;
+
+    while(copied < Count)
+    {
+        mempool_headSeek(pSrc, &p_state->Read, &p_state->ReadBase, p_state->ReadIndex);
+        p_read = mempool_linkSect(pSrc, p_state->Read);
+        read_index = p_state->ReadIndex - p_state->ReadBase;
+        bytes_to_copy = mempool_sectFill(p_read) - read_index;
+        if(bytes_to_copy > (Count - copied))
+        {
+            bytes_to_copy = Count - copied;
+        }
+
+        written = mempool_writeChain(pMem, NULL, pDst, mempool_sectData(p_read) + read_index, bytes_to_copy);
+        p_state->ReadIndex += written;
+        copied += written;
+        if(written < bytes_to_copy)
+        {
+            // Memory all consumed
+            break;
+        }
+    }
+
+    mempool_statBytes(mempool_sectPool(pSrc), 0uL, copied);
+    return copied;
+}
+
+/* **************************************************************************
+ * Function moves the unread data of one chain to the end of another. Only the
+ * unread part of the source read sector is copied, the sectors after it are
+ * relinked to the destination and the sector they follow keeps the bytes
+ * past its data as a gap. The source is left empty with its head sector and
+ * both chains are freed as usual afterwards. Not for chains of a stream.
+ *  pMem        ->  Pointer to the memory the destination grows from for the copy
+ *  pDstSect    ->  Pointer to memory sector start descriptor receiving the data
+ *  pSrcSect    ->  Pointer to memory sector start descriptor giving the data
+ * Returns number of bytes moved, fewer than were unread if the pool is exhausted
+ ************************************************************************** */
+unsigned long mempool_splice(const void *const pMem, const void *const pDstSect, const void *const pSrcSect)
+{
+    t_MemSect *p_dst = (t_MemSect *)pDstSect;
+    t_MemSect *p_src = (t_MemSect *)pSrcSect;
+    t_MemHead *p_dst_state = NULL;
+    t_MemHead *p_src_state = NULL;
+    t_MemSect *p_read = NULL;
+    t_MemSect *p_write = NULL;
+    t_MemSect *p_next = NULL;
+    t_MemSect *p_tail = NULL;
+    t_MemSect *p_mem = NULL;
+    unsigned long available = 0;
+    unsigned long edge = 0;
+    unsigned long moved = 0;
+    unsigned long rest = 0;
+    uint32_t link = 0;
+
+    if((p_dst == NULL) || (p_src == NULL) || (p_dst == p_src) || mempool_chainShared(p_dst) || mempool_chainShared(p_src))
+    {
+        return 0;
+    }
+    p_dst_state = mempool_sectHead(p_dst);
+    p_src_state = mempool_sectHead(p_src);
+
+    available = p_src_state->WriteIndex - p_src_state->ReadIndex;
+    if(available == 0)
+    {
+        return 0;
+    }
+    mempool_headSeek(p_src, &p_src_state->Write, &p_src_state->WriteBase, p_src_state->WriteIndex);
+    mempool_headSeek(p_src, &p_src_state->Read, &p_src_state->ReadBase, p_src_state->ReadIndex);
+    p_read = mempool_linkSect(p_src, p_src_state->Read);
+    p_write = mempool_linkSect(p_src, p_src_state->Write);
+
+    // Unread part of the read sector is copied, the sectors after it start at their first byte
+    edge = (p_read == p_write) ? available : (mempool_sectFill(p_read) - (p_src_state->ReadIndex - p_src_state->ReadBase));
+    moved = mempool_spliceCopy(pMem, p_dst, p_src, edge);
+    if((moved < edge) || (moved == available))
+    {
+        if(p_src->Flags & MEMSECT_FLAGS_RECLAIM)
+        {
+            mempool_chainReclaim(p_src);
+        }
+        return moved;
+    }
+
+    // Every sector taken over must be reachable from the destination head
+    p_next = mempool_sectNext(p_read);
+    p_tail = mempool_linkSect(p_dst, p_dst_state->Write);
+    link = mempool_sectLink(p_tail, p_next);
+    for(p_mem = p_next; (link != 0u) && (p_mem != NULL); p_mem = (p_mem->Flags & MEMSECT_FLAGS_CONCAT) ? mempool_sectNext(p_mem) : NULL)
+    {
+        if(mempool_sectLink(p_dst, p_mem) == 0u)
+        {
+            link = 0u;
+        }
+    }
+    if(link == 0u)
+    {
+        // Chain would span more than MEM_POOL_PEER_MAX other pools, copied instead
+        moved += mempool_spliceCopy(pMem, p_dst, p_src, available - moved);
+        if(p_src->Flags & MEMSECT_FLAGS_RECLAIM)
+        {
+            mempool_chainReclaim(p_src);
+        }
+        return moved;
+    }
+
+    // Spare sectors after the destination write index hold no data
+    if(p_tail->Flags & MEMSECT_FLAGS_CONCAT)
+    {
+        mempool_chainRelease(mempool_sectNext(p_tail), NULL);
+    }
+    p_tail->Gap = (uint32_t)(mempool_sectSize(p_tail) - (p_dst_state->WriteIndex - p_dst_state->WriteBase));
+    __atomic_store_n(&p_tail->Concat, link, __ATOMIC_RELAXED);
+    p_tail->Flags |= MEMSECT_FLAGS_CONCAT;
+    p_dst->Flags |= MEMSECT_FLAGS_SPLICED;
+
+    // Source indices carried over, the sector after the read sector starts at the destination write index
+    rest = p_src_state->WriteIndex - p_src_state->ReadIndex;
+    p_dst_state->WriteBase = p_dst_state->WriteIndex + (p_src_state->WriteBase - p_src_state->ReadIndex);
+    p_dst_state->Write = mempool_sectLink(p_dst, p_write);
+    p_dst_state->WriteIndex += rest;
+
+    // Source keeps its head sector, the sectors up to the read sector are fully read
+    p_read->Flags &= ~MEMSECT_FLAGS_CONCAT;
+    p_read->Concat = 0u;
+    if(p_read != p_src)
+    {
+        mempool_chainRelease(mempool_sectNext(p_src), NULL);
+        p_src->Flags &= ~MEMSECT_FLAGS_CONCAT;
+        p_src->Concat = 0u;
+    }
+    mempool_resetMemory(p_src);
+
+    mempool_statBytes(mempool_sectPool(p_src), 0uL, rest);
+    mempool_statBytes(mempool_sectPool(p_dst), rest, 0uL);
+
+    return moved + rest;
+}
+
+/* **************************************************************************
+ * Function makes a new chain sharing the data of another, the clone has its
+ * own read index starting at the read index of the original. Its head sector
+ * holds no data, it links to the original head which takes a reference, and
+ * the shared sectors go back to the pool when the last of the chains is
+ * freed. Both chains are read only and not reclaimed meanwhile, a clone
+ * gives its share up with mempool_resetTrim. Not for chains of a stream.
+ *  pMemSect    ->  Pointer to memory sector start descriptor to be cloned
+ * Returns the Sector Pointer of the clone, NULL if the pool is exhausted or
+ * the head already holds the most references
+ ************************************************************************** */
+void *mempool_clone(const void *const pMemSect)
+{
+    t_MemSect *p_head = (t_MemSect *)pMemSect;
+    t_MemSect *p_clone = NULL;
+
+    if((p_head == NULL) || ((__atomic_load_n(&p_head->Flags, __ATOMIC_RELAXED) & MEMSECT_FLAGS_REFS) == MEMSECT_FLAGS_REFS))
+    {
+        return NULL;
+    }
+
+    p_clone = (t_MemSect *)mempool_alloc(mempool_sectPool(p_head));
+    if(p_clone == NULL)
+    {
+        return NULL;
+    }
+
+    // Reference taken before anything links to the head, clones may be freed by other threads
+    __atomic_add_fetch(&p_head->Flags, MEMSECT_FLAGS_REF, __ATOMIC_RELAXED);
+    p_clone->Gap = (uint32_t)mempool_sectSize(p_clone);
+    __atomic_store_n(&p_clone->Concat, MEM_POOL_LINK(0u, p_head->Self), __ATOMIC_RELAXED);
+    p_clone->Flags |= MEMSECT_FLAGS_CONCAT | MEMSECT_FLAGS_CLONE;
+    // Same pool as the head, so the cursor links and indices hold as they are
+    *mempool_sectHead(p_clone) = *mempool_sectHead(p_head);
+
+    return (void *)p_clone;
+}
+
+/* **************************************************************************
+ * Function scans a piece of sector buffer for a pattern, the vector kernels
+ * match the first and last byte of the pattern at 32 or 16 positions at once
+ * and compare the whole pattern only where both match
+ *  pData       ->  Pointer to the data to be scanned
+ *  Size        ->  Bytes of data, at least PatternSize
+ *  pPattern    ->  Pointer to the pattern
+ *  PatternSize ->  Bytes of the pattern, not zero
+ * Returns position of the first match, Size if the data holds none
+ ************************************************************************** */
+static unsigned long mempool_scanData(const char *pData, const unsigned long Size, const char *pPattern,\
+                                        const unsigned long PatternSize)
+{
+    const unsigned long last = PatternSize - 1u;
+    const unsigned long count = Size - last;
+    const char *p_hit = NULL;
+    unsigned long index = 0;
+    uint32_t mask = 0;
+#if defined(__AVX2__)
+    const __m256i first_256 = _mm256_set1_epi8(pPattern[0]);
+    const __m256i last_256 = _mm256_set1_epi8(pPattern[last]);
+#endif
+#if defined(__SSE2__)
+    const __m128i first_128 = _mm_set1_epi8(pPattern[0]);
+    const __m128i last_128 = _mm_set1_epi8(pPattern[last]);
+#endif
+
+#if defined(__AVX2__)
+    for(; (index + 32u) <= count; index += 32u)
+    {
+        mask = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(\
+                    _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(pData + index)), first_256),\
+                    _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(pData + index + last)), last_256)));
+        while(mask != 0u)
+        {
+            if(memcmp(pData + index + __builtin_ctz(mask), pPattern, PatternSize) == 0)
+            {
+                return index + (unsigned long)__builtin_ctz(mask);
+            }
+            mask &= mask - 1u;
+        }
+    }
+#endif
+#if defined(__SSE2__)
+    for(; (index + 16u) <= count; index += 16u)
+    {
+        mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(\
+                    _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(pData + index)), first_128),\
+                    _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(pData + index + last)), last_128)));
+        while(mask != 0u)
+        {
+            if(memcmp(pData + index + __builtin_ctz(mask), pPattern, PatternSize) == 0)
+            {
+                return index + (unsigned long)__builtin_ctz(mask);
+            }
+            mask &= mask - 1u;
+        }
+    }
+#endif
+    (void)mask;
+
+    // Rest of the data, or all of it without vector support
+    while(index < count)
+    {
+        p_hit = (const char *)memchr(pData + index, (unsigned char)pPattern[0], count - index);
+        if(p_hit == NULL)
+        {
+            break;
+        }
+        index = (unsigned long)(p_hit - pData);
+        if(memcmp(p_hit, pPattern, PatternSize) == 0)
+        {
+            return index;
+        }
+        index++;
+    }
+
+    return Size;
+}
+
+/* **************************************************************************
+ * Function compares a pattern with chain data that may cross into the
+ * following sectors
+ *  pSect       ->  Sector holding the first byte to be compared
+ *  Base        ->  Index at which pSect starts
+ *  Index       ->  Index of the first byte to be compared
+ *  pPattern    ->  Pointer to the pattern
+ *  PatternSize ->  Bytes of the pattern, all of them written to the chain
+ * Returns 1 if the data matches the pattern, 0 otherwise
+ ************************************************************************** */
+static int mempool_chainMatch(t_MemSect *pSect, unsigned long Base, const unsigned long Index, const char *pPattern,\
+                                const unsigned long PatternSize)
+{
+    unsigned long matched = 0;
+    unsigned long sect_index = 0;
+    unsigned long bytes_cmp = 0;
+
+    while(matched < PatternSize)
+    {
+        mempool_cursorSeek(&pSect, &Base, Index + matched);
+        sect_index = (Index + matched) - Base;
+        bytes_cmp = mempool_sectFill(pSect) - sect_index;
+        if(bytes_cmp > (PatternSize - matched))
+        {
+            bytes_cmp = PatternSize - matched;
+        }
+        if(memcmp(mempool_sectData(pSect) + sect_index, pPattern + matched, bytes_cmp) != 0)
+        {
+            return 0;
+        }
+        matched += bytes_cmp;
+    }
+
+    return 1;
+}
+
+/* **************************************************************************
+ * Function looks for a pattern in the unread data, the sectors are scanned
+ * in place from the read index on and a match may cross sector boundaries.
+ * Neither index moves, reading as many bytes as the result gives stops the
+ * read index right before the match.
+ *  pMemSect    ->  Pointer to memory sector start descriptor to be scanned
+ *  pPattern    ->  Pointer to the pattern
+ *  PatternSize ->  Bytes of the pattern
+ * Returns offset of the first match from the read index, MEM_POOL_NOT_FOUND
+ * if the unread data holds none
+ ************************************************************************** */
+unsigned long mempool_findPattern(const void *const pMemSect, const void *const pPattern, const unsigned long PatternSize)
+{
+    t_MemSect *p_head = (t_MemSect *)pMemSect;
+    const char *p_pattern = (const char *)pPattern;
+    t_MemHead *p_state = NULL;
+    t_MemSect *p_mem = NULL;
+    const char *p_data = NULL;
+    unsigned long base = 0;
+    unsigned long index = 0;
+    unsigned long end = 0;
+    unsigned long sect_index = 0;
+    unsigned long sect_end = 0;
+    unsigned long found = 0;
+
+    if((p_head == NULL) || (p_pattern == NULL) || (PatternSize == 0uL))
+    {
+        return MEM_POOL_NOT_FOUND;
+    }
+    p_state = mempool_sectHead(p_head);
+
+    p_mem = mempool_linkSect(p_head, p_state->Read);
+    base = p_state->ReadBase;
+    index = p_state->ReadIndex;
+    end = p_state->WriteIndex;
+
+    while((end - index) >= PatternSize)
+    {
+        mempool_cursorSeek(&p_mem, &base, index);
+        p_data = mempool_sectData(p_mem);
+        sect_index = index - base;
+        sect_end = mempool_sectFill(p_mem);
+        if(sect_end > (end - base))
+        {
+            sect_end = end - base;
+        }
+
+        // Matches lying in this sector
+        if((sect_end - sect_index) >= PatternSize)
+        {
+            found = mempool_scanData(p_data + sect_index, sect_end - sect_index, p_pattern, PatternSize);
+            if(found < (sect_end - sect_index))
+            {
+                return (index + found) - p_state->ReadIndex;
+            }
+            index = base + sect_end - (PatternSize - 1u);
+        }
+
+        // Matches starting in the last bytes and crossing into the next sector
+        while(((index - base) < sect_end) && ((end - index) >= PatternSize))
+        {
+            if((p_data[index - base] == p_pattern[0]) && mempool_chainMatch(p_mem, base, index, p_pattern, PatternSize))
+            {
+                return index - p_state->ReadIndex;
+            }
+            index++;
+        }
+    }
+
+    return MEM_POOL_NOT_FOUND;
+}
+
+/* **************************************************************************
+ * Function looks for a byte in the unread data, such as the delimiter ending
+ * a line, see mempool_findPattern
+ *  pMemSect    ->  Pointer to memory sector start descriptor to be scanned
+ *  Byte        ->  Byte to be found
+ * Returns offset of the first such byte from the read index,
+ * MEM_POOL_NOT_FOUND if the unread data holds none
+ ************************************************************************** */
+unsigned long mempool_find(const void *const pMemSect, const unsigned char Byte)
 {
-    unsigned long total_size = ((struct s_Mem *)pMem)->Total_Memory;
-    unsigned long sect_cnt = ((struct s_Mem *)pMem)->Sec_Cnt;
-    unsigned long sect_size = ((struct s_Mem *)pMem)->Sec_Size;
-    return (((((double)(sect_cnt * sect_size)) * 100.0) / (double)total_size));
+    return mempool_findPattern(pMemSect, &Byte, 1uL);
+}
+
+#if defined(MEM_POOL_POSIX)
+/* **************************************************************************
+ * Function maps a pool sized at run time and initializes it, for pools too
+ * large or too late known for MEM_POOL_DECLARE
+ *  SectCnt     ->  Number of sectors of the pool
+ *  SectSize    ->  Size of each memory sector
+ *  Flags       ->  MEM_POOL_FLAGS_CONCURRENT as for mempool_initWithFlags, and
+ *                  MEM_POOL_FLAGS_HUGETLB maps explicit huge pages, falls
+ *                  back to base pages when none are reserved
+ *                  MEM_POOL_FLAGS_HUGEPAGE asks for transparent huge pages
+ *                  MEM_POOL_FLAGS_POPULATE faults every page in up front
+ * Returns the start address of the initialized Heap, NULL if the pool size
+ * wraps around, a sector is empty or exceeds 32 bits or mapping failed
+ ************************************************************************** */
+void *mempool_create(const unsigned long SectCnt, const unsigned long SectSize, const unsigned long Flags)
+{
+    struct s_Mem *p_pool = NULL;
+    void *p_map = MAP_FAILED;
+    size_t map_size = mempool_poolBytes(SectCnt, SectSize);
+    size_t offset = 0;
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    unsigned long flags = Flags | MEM_POOL_FLAGS_MAPPED;
+    int map_flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+    if((SectCnt > MEM_POOL_SECT_LIMIT) || (map_size == 0u))
+    {
+        // Sector index no longer fits a link or the size wraps around
+        return NULL;
+    }
+
+#if defined(MAP_POPULATE)
+    if((Flags & (MEM_POOL_FLAGS_POPULATE | MEM_POOL_FLAGS_HUGEPAGE)) == MEM_POOL_FLAGS_POPULATE)
+    {
+        map_flags |= MAP_POPULATE;
+    }
+#endif
+
+#if defined(MAP_HUGETLB)
+    if(Flags & MEM_POOL_FLAGS_HUGETLB)
+    {
+        // Huge page mappings are whole huge pages long
+        p_map = mmap(NULL, (map_size + MEM_POOL_HUGE_PAGE - 1) & ~(size_t)(MEM_POOL_HUGE_PAGE - 1), PROT_READ | PROT_WRITE,\
+                        map_flags | MAP_HUGETLB, -1, 0);
+        if(p_map != MAP_FAILED)
+        {
+            map_size = (map_size + MEM_POOL_HUGE_PAGE - 1) & ~(size_t)(MEM_POOL_HUGE_PAGE - 1);
+        }
+    }
+#endif
+
+    if(p_map == MAP_FAILED)
+    {
+        // No huge pages reserved or not asked for, base pages then
+        flags &= ~MEM_POOL_FLAGS_HUGETLB;
+        p_map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, map_flags, -1, 0);
+        if(p_map == MAP_FAILED)
+        {
+            return NULL;
+        }
+#if defined(MADV_HUGEPAGE)
+        if(Flags & MEM_POOL_FLAGS_HUGEPAGE)
+        {
+            // Advice has to come before the first touch, so populate by hand
+            (void)madvise(p_map, map_size, MADV_HUGEPAGE);
+        }
+#endif
+        if((Flags & (MEM_POOL_FLAGS_POPULATE | MEM_POOL_FLAGS_HUGEPAGE)) == (MEM_POOL_FLAGS_POPULATE | MEM_POOL_FLAGS_HUGEPAGE))
+        {
+            for(offset = 0; offset < map_size; offset += page)
+            {
+                ((volatile char *)p_map)[offset] = 0;
+            }
+        }
+    }
+
+    p_pool = (struct s_Mem *)mempool_initWithFlags(p_map, (unsigned long)map_size, SectCnt, SectSize, flags);
+    p_pool->Map_Size = map_size;
+
+    return (void *)p_pool;
+}
+
+/* **************************************************************************
+ * Function maps a pool able to grow, address space for SectMax sectors is
+ * reserved up front but only SectCnt of them are backed by memory. When the
+ * free list runs dry allocation and chain extension commit GrowStep more.
+ *  SectCnt     ->  Number of sectors usable from the start, the pool never
+ *                  shrinks below it
+ *  SectMax     ->  Upper bound of sectors the pool grows to
+ *  GrowStep    ->  Number of sectors added at once
+ *  SectSize    ->  Size of each memory sector
+ *  Flags       ->  MEM_POOL_FLAGS_CONCURRENT as for mempool_initWithFlags,
+ *                  MEM_POOL_FLAGS_HUGEPAGE asks for transparent huge pages
+ * Returns the start address of the initialized Heap, NULL if the pool size
+ * wraps around, a sector is empty or exceeds 32 bits or mapping failed
+ ************************************************************************** */
+void *mempool_createGrowable(const unsigned long SectCnt, const unsigned long SectMax, const unsigned long GrowStep,\
+                                const unsigned long SectSize, const unsigned long Flags)
+{
+    struct s_Mem *p_pool = NULL;
+    void *p_map = MAP_FAILED;
+    size_t map_size = mempool_poolBytes(SectMax, SectSize);
+    uintptr_t desc_start = 0;
+    uintptr_t head_start = 0;
+    uintptr_t data_start = 0;
+
+    if((SectCnt > SectMax) || (SectMax > MEM_POOL_SECT_LIMIT) || (GrowStep == 0) || (map_size == 0u))
+    {
+        return NULL;
+    }
+
+    // Address space only, pages are committed as the pool grows
+    p_map = mmap(NULL, map_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if(p_map == MAP_FAILED)
+    {
+        return NULL;
+    }
+#if defined(MADV_HUGEPAGE)
+    if(Flags & MEM_POOL_FLAGS_HUGEPAGE)
+    {
+        (void)madvise(p_map, map_size, MADV_HUGEPAGE);
+    }
+#endif
+
+    // Header and the first SectCnt sectors, where mempool_layout puts them
+    desc_start = (uintptr_t)p_map + MEM_POOL_ROUND(memCtxSize);
+    head_start = desc_start + MEM_POOL_ROUND(SectMax * memSectorCtxSize);
+    data_start = head_start + MEM_POOL_ROUND(SectMax * memHeadCtxSize);
+    if(!mempool_mapCommit((uintptr_t)p_map, desc_start + (SectCnt * memSectorCtxSize)) ||\
+        !mempool_mapCommit(head_start, head_start + (SectCnt * memHeadCtxSize)) ||\
+        !mempool_mapCommit(data_start, data_start + (SectCnt * MEM_POOL_ROUND(SectSize))))
+    {
+        (void)munmap(p_map, map_size);
+        return NULL;
+    }
+
+    p_pool = mempool_layout(p_map, (unsigned long)map_size, SectCnt, SectMax, SectSize,\
+                                (Flags & ~(MEM_POOL_FLAGS_HUGETLB | MEM_POOL_FLAGS_POPULATE)) | MEM_POOL_FLAGS_MAPPED | MEM_POOL_FLAGS_GROWABLE);
+    p_pool->Grow_Step = GrowStep;
+    p_pool->Map_Size = map_size;
+
+    return (void *)p_pool;
+}
+
+/* **************************************************************************
+ * Function lays a concurrent pool out in a shared memory object, every
+ * process mapping the object with mempool_shmAttach sees the same pool. All
+ * addresses kept in the pool are relative to it, so mappings may sit at
+ * different addresses. Chains pass between processes as mempool_sectHandle.
+ *  Fd          ->  Descriptor of a shared memory object, from shm_open or
+ *                  memfd_create, it is resized to fit the pool
+ *  SectCnt     ->  Number of sectors
+ *  SectSize    ->  Size of each memory sector
+ *  Flags       ->  MEM_POOL_FLAGS_POPULATE faults every page in before returning
+ * Returns the start address of the pool in this process, NULL if sizing or
+ * mapping failed
+ ************************************************************************** */
+void *mempool_shmCreate(const int Fd, const unsigned long SectCnt, const unsigned long SectSize, const unsigned long Flags)
+{
+    struct s_Mem *p_pool = NULL;
+    void *p_map = MAP_FAILED;
+    size_t map_size = mempool_poolBytes(SectCnt, SectSize);
+    int map_flags = MAP_SHARED;
+
+    if((SectCnt > MEM_POOL_SECT_LIMIT) || (map_size == 0u))
+    {
+        return NULL;
+    }
+    if(ftruncate(Fd, (off_t)map_size) != 0)
+    {
+        return NULL;
+    }
+
+#if defined(MAP_POPULATE)
+    if(Flags & MEM_POOL_FLAGS_POPULATE)
+    {
+        map_flags |= MAP_POPULATE;
+    }
+#endif
+    p_map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, map_flags, Fd, 0);
+    if(p_map == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    // Other processes take their sectors from the same free list, so always lock-free
+    p_pool = (struct s_Mem *)mempool_initWithFlags(p_map, (unsigned long)map_size, SectCnt, SectSize,\
+                                                    MEM_POOL_FLAGS_CONCURRENT | MEM_POOL_FLAGS_MAPPED | MEM_POOL_FLAGS_SHARED);
+    __atomic_store_n(&p_pool->Map_Size, map_size, __ATOMIC_RELEASE);
+
+    return (void *)p_pool;
+}
+
+/* **************************************************************************
+ * Function maps a pool laid out by mempool_shmCreate into this process,
+ * mempool_destroy removes the mapping again
+ *  Fd          ->  Descriptor of the shared memory object holding the pool
+ * Returns the start address of the pool in this process, NULL if the object
+ * holds no shared pool
+ ************************************************************************** */
+void *mempool_shmAttach(const int Fd)
+{
+    struct s_Mem *p_pool = NULL;
+    void *p_map = MAP_FAILED;
+    struct stat st;
+
+    if((fstat(Fd, &st) != 0) || ((size_t)st.st_size < MEM_POOL_BYTES(0, 0)))
+    {
+        return NULL;
+    }
+    p_map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, Fd, 0);
+    if(p_map == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    // Mappings start on a page, the pool header sits right at the start
+    p_pool = (struct s_Mem *)p_map;
+    if(!(p_pool->Flags & MEM_POOL_FLAGS_SHARED) || (__atomic_load_n(&p_pool->Map_Size, __ATOMIC_ACQUIRE) != (size_t)st.st_size))
+    {
+        (void)munmap(p_map, (size_t)st.st_size);
+        return NULL;
+    }
+
+    return (void *)p_pool;
+}
+
+/* **************************************************************************
+ * Function checksums a block of memory eight bytes at a time
+ *  pData       ->  Pointer to the block
+ *  Size        ->  Size of the block
+ * Returns the checksum.
+ ************************************************************************** */
+static uint64_t mempool_checksum(const void *const pData, const size_t Size)
+{
+    const unsigned char *p_byte = (const unsigned char *)pData;
+    uint64_t sum = 0xCBF29CE484222325uLL;
+    uint64_t word = 0;
+    size_t index = 0;
+
+    for(index = 0; (index + sizeof(word)) <= Size; index += sizeof(word))
+    {
+        memcpy(&word, p_byte + index, sizeof(word));
+        sum = (sum ^ word) * 0x100000001B3uLL;
+    }
+    for(; index < Size; index++)
+    {
+        sum = (sum ^ p_byte[index]) * 0x100000001B3uLL;
+    }
+
+    return sum ^ (sum >> 32);
+}
+
+/* **************************************************************************
+ * Function fills the snapshot trailer for the build reading or writing it
+ *  pSnap       ->  Pointer to the trailer
+ * Returns none.
+ ************************************************************************** */
+static void mempool_snapStamp(t_MemSnap *pSnap)
+{
+    pSnap->Magic = (uint32_t)MEM_POOL_SNAP_MAGIC;
+    pSnap->Version = (uint32_t)MEM_POOL_SNAP_VERSION;
+    pSnap->Align = (uint32_t)MEM_POOL_ALIGN;
+    pSnap->Ctx_Size = (uint32_t)((memCtxSize << 20) | (memSectorCtxSize << 10) | memHeadCtxSize);
+}
+
+/* **************************************************************************
+ * Function writes the pool as it is to a file, header, descriptors, chain
+ * states and sector buffers in one image followed by a versioned trailer with
+ * a checksum of the metadata. Nothing may change the pool meanwhile. Growable
+ * pools and pools whose chains continue into other pools are refused.
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_init
+ *  pPath       ->  File to be written, replaced once the image is complete
+ * Returns number of bytes written, zero if failed
+ ************************************************************************** */
+unsigned long mempool_snapshot(const void *const pMem, const char *const pPath)
+{
+    struct s_Mem *p_pool = (struct s_Mem *)pMem;
+    const char *p_out = (const char *)pMem;
+    char tmp_path[4096];
+    t_MemSnap snap;
+    size_t written = 0;
+    ssize_t result = 0;
+    int complete = 0;
+    int fd = -1;
+
+    if((p_pool->Flags & MEM_POOL_FLAGS_GROWABLE) || (p_pool->pPeer[0] != NULL))
+    {
+        // Holes in the mapping, or links to pools the file does not hold
+        return 0;
+    }
+    if(snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", pPath) >= (int)sizeof(tmp_path))
+    {
+        return 0;
+    }
+
+    memset(&snap, 0, sizeof(snap));
+    mempool_snapStamp(&snap);
+    snap.Pool_Size = (uint64_t)(p_pool->Mem_Start + (p_pool->Sec_Max * p_pool->Sec_Stride));
+    snap.Meta_Size = (uint64_t)p_pool->Mem_Start;
+    snap.Checksum = mempool_checksum(pMem, (size_t)snap.Meta_Size);
+
+    fd = open(tmp_path, O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    if(fd < 0)
+    {
+        return 0;
+    }
+    // Pool image first so it maps from offset 0, whatever the page size
+    while(written < (size_t)snap.Pool_Size)
+    {
+        result = write(fd, p_out + written, (size_t)snap.Pool_Size - written);
+        if(result <= 0)
+        {
+            break;
+        }
+        written += (size_t)result;
+    }
+    complete = (written == (size_t)snap.Pool_Size) && (write(fd, &snap, sizeof(snap)) == (ssize_t)sizeof(snap)) && (fsync(fd) == 0);
+    complete = (close(fd) == 0) && complete;
+    // Readers see either the old file or the complete new one
+    if(!complete || (rename(tmp_path, pPath) != 0))
+    {
+        (void)unlink(tmp_path);
+        return 0;
+    }
+
+    return (unsigned long)(written + sizeof(snap));
+}
+
+/* **************************************************************************
+ * Function maps a file written by mempool_snapshot as a private copy of the
+ * pool, every chain allocated at the time of the snapshot is readable again
+ * through mempool_handleSect. Only the metadata is verified, sector buffers
+ * are paged in when first touched, so restore time does not depend on the
+ * data held. The pool is released by mempool_destroy.
+ *  pPath       ->  File written by mempool_snapshot
+ * Returns the start address of the restored pool, NULL if the file is not a
+ * snapshot of this build or fails its checksum
+ ************************************************************************** */
+void *mempool_restore(const char *const pPath)
+{
+    struct s_Mem *p_pool = NULL;
+    void *p_map = MAP_FAILED;
+    t_MemSnap snap;
+    t_MemSnap expect;
+    struct stat st;
+    int fd = -1;
+
+    fd = open(pPath, O_RDONLY);
+    if(fd < 0)
+    {
+        return NULL;
+    }
+    memset(&expect, 0, sizeof(expect));
+    mempool_snapStamp(&expect);
+    if((fstat(fd, &st) != 0) || ((size_t)st.st_size < sizeof(snap)) ||\
+        (pread(fd, &snap, sizeof(snap), st.st_size - (off_t)sizeof(snap)) != (ssize_t)sizeof(snap)) ||\
+        (snap.Magic != expect.Magic) || (snap.Version != expect.Version) || (snap.Align != expect.Align) ||\
+        (snap.Ctx_Size != expect.Ctx_Size) || ((snap.Pool_Size + sizeof(snap)) != (uint64_t)st.st_size) ||\
+        (snap.Meta_Size < memCtxSize) || (snap.Meta_Size > snap.Pool_Size))
+    {
+        (void)close(fd);
+        return NULL;
+    }
+
+    // Private copy on write mapping, pages come in from the file as touched
+    p_map = mmap(NULL, (size_t)snap.Pool_Size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    (void)close(fd);
+    if(p_map == MAP_FAILED)
+    {
+        return NULL;
+    }
+    if(mempool_checksum(p_map, (size_t)snap.Meta_Size) != snap.Checksum)
+    {
+        (void)munmap(p_map, (size_t)snap.Pool_Size);
+        return NULL;
+    }
+
+    // Offsets and links hold at any address, only the mapping itself is new
+    p_pool = (struct s_Mem *)p_map;
+    p_pool->Flags = (p_pool->Flags & MEM_POOL_FLAGS_CONCURRENT) | MEM_POOL_FLAGS_MAPPED;
+    // Waiters and the eventfd belonged to the process that wrote the snapshot
+    p_pool->Wait_Mask = 0u;
+    p_pool->Event_Fd = -1;
+    p_pool->Map_Size = (size_t)snap.Pool_Size;
+    p_pool->Grow_Lock = 0uL;
+
+    return (void *)p_pool;
+}
+
+/* **************************************************************************
+ * Function returns the idle segments at the end of a growable pool to the
+ * system, down to the sectors the pool was created with. Nothing else may use
+ * the pool meanwhile and per thread caches of it must be flushed first.
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_createGrowable
+ * Returns number of sectors released.
+ ************************************************************************** */
+unsigned long mempool_shrink(const void *const pMem)
+{
+    struct s_Mem *p_pool = (struct s_Mem *)pMem;
+    t_MemSect *p_desc = MEM_POOL_DESC(p_pool);
+    t_MemHead *p_state = MEM_POOL_HEADS(p_pool);
+    t_MemSect *p_sect = NULL;
+    t_MemSect *p_head = NULL;
+    uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t desc_end = 0;
+    unsigned long sect_cnt = p_pool->Sec_Cnt;
+    unsigned long keep = sect_cnt;
+    unsigned long index = 0;
+
+    if(!(p_pool->Flags & MEM_POOL_FLAGS_GROWABLE))
+    {
+        return 0;
+    }
+
+    // Mark what sits on the free list, the rest is in use or cached
+    if(p_pool->Flags & MEM_POOL_FLAGS_CONCURRENT)
+    {
+        p_sect = (MEM_POOL_TOP_INDEX(p_pool->Free_Top) != 0uL) ? &p_desc[MEM_POOL_TOP_INDEX(p_pool->Free_Top) - 1uL] : NULL;
+    }
+    else
+    {
+        p_sect = (p_pool->Free_Head != 0uL) ? &p_desc[MEM_POOL_LINK_INDEX((uint32_t)p_pool->Free_Head)] : NULL;
+    }
+    while(p_sect != NULL)
+    {
+        p_sect->Flags |= MEMSECT_FLAGS_LISTED;
+        p_sect = mempool_sectNext(p_sect);
+    }
+
+    // Whole segments from the end holding no sector in use
+    while((keep > p_pool->Sec_Min) && (p_desc[keep - 1].Flags & MEMSECT_FLAGS_LISTED))
+    {
+        keep--;
+    }
+    keep = p_pool->Sec_Min + ((((keep - p_pool->Sec_Min) + p_pool->Grow_Step) - 1) / p_pool->Grow_Step) * p_pool->Grow_Step;
+    keep = (keep < sect_cnt) ? keep : sect_cnt;
+
+    // Rebuild the free list from the sectors kept, lowest address first
+    for(index = sect_cnt; index > 0; index--)
+    {
+        if(p_desc[index - 1].Flags & MEMSECT_FLAGS_LISTED)
+        {
+            p_desc[index - 1].Flags &= ~MEMSECT_FLAGS_LISTED;
+            if((index - 1) < keep)
+            {
+                p_desc[index - 1].Concat = (p_head != NULL) ? MEM_POOL_LINK(0u, p_head->Self) : 0u;
+                p_head = &p_desc[index - 1];
+            }
+        }
+    }
+    p_pool->Free_Head = (p_head != NULL) ? MEM_POOL_LINK(0u, p_head->Self) : 0u;
+    p_pool->Free_Top = MEM_POOL_TOP(MEM_POOL_TOP_TAG(p_pool->Free_Top) + 1uLL, (p_head != NULL) ? MEM_POOL_LINK(0u, p_head->Self) : 0u);
+    p_pool->Sec_Cnt = keep;
+
+    // Last descriptor page may share with the chain states, last chain state
+    // page with the first sector buffers, they stay then
+    desc_end = (uintptr_t)&p_desc[sect_cnt] + page - 1u;
+    mempool_mapRelease((uintptr_t)&p_desc[keep], (desc_end < (uintptr_t)p_state) ? desc_end : (uintptr_t)p_state);
+    desc_end = (uintptr_t)&p_state[sect_cnt] + page - 1u;
+    mempool_mapRelease((uintptr_t)&p_state[keep], (desc_end < MEM_POOL_DATA(p_pool)) ? desc_end : MEM_POOL_DATA(p_pool));
+    mempool_mapRelease(MEM_POOL_DATA(p_pool) + (keep * p_pool->Sec_Stride), MEM_POOL_DATA(p_pool) + (sect_cnt * p_pool->Sec_Stride) + page - 1u);
+
+    return sect_cnt - keep;
+}
+
+/* **************************************************************************
+ * Function unmaps a pool made by mempool_create, mempool_createGrowable,
+ * mempool_shmCreate, mempool_shmAttach or mempool_restore, every sector handle
+ * of it becomes invalid in this process. Pools from MEM_POOL_DECLARE are left untouched.
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_create
+ * Returns none.
+ ************************************************************************** */
+void mempool_destroy(const void *const pMem)
+{
+    if((pMem != NULL) && (((struct s_Mem *)pMem)->Flags & MEM_POOL_FLAGS_MAPPED))
+    {
+        mempool_eventClose(pMem);
+        (void)munmap((void *)pMem, ((struct s_Mem *)pMem)->Map_Size);
+    }
+}
+
+/* **************************************************************************
+ * Function allocates a sector, waiting for one to be freed by another thread
+ * or process while the pool is exhausted. Sectors kept in a per thread cache
+ * do not end the wait until the cache spills them back to the pool.
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_init
+ *  Timeout     ->  Milliseconds to wait, negative waits forever
+ * Returns the Sector Pointer, NULL if none was freed in time or the pool is
+ * not MEM_POOL_FLAGS_CONCURRENT, no other thread could free one then
+ ************************************************************************** */
+void *mempool_allocWait(const void *const pMem, const long Timeout)
+{
+    struct s_Mem *p_pool = (struct s_Mem *)pMem;
+    struct timespec deadline;
+    struct timespec *p_deadline = NULL;
+    void *p_sect = NULL;
+    uint32_t seq = 0;
+    uint32_t join = 0;
+    int poll = 0;
+
+    p_sect = mempool_alloc(pMem);
+    if((p_sect != NULL) || (Timeout == 0) || !(p_pool->Flags & MEM_POOL_FLAGS_CONCURRENT))
+    {
+        return p_sect;
+    }
+
+    p_deadline = mempool_deadline(&deadline, Timeout);
+    join = mempool_waitJoin(p_pool, MEM_POOL_WAIT_FREE, MEM_POOL_WAIT_FREE_ALL, &poll);
+    do
+    {
+        seq = __atomic_load_n(&p_pool->Wait_Seq, __ATOMIC_ACQUIRE);
+        // A sector freed before this fence is seen by the allocation, one freed after it wakes the wait
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        p_sect = mempool_alloc(pMem);
+    } while((p_sect == NULL) && mempool_waitFor(p_pool, seq, p_deadline, poll));
+    __atomic_sub_fetch(&p_pool->Wait_Mask, join, __ATOMIC_SEQ_CST);
+
+    return p_sect;
+}
+
+/* **************************************************************************
+ * Function waits, consumer thread only, until the stream holds Count bytes.
+ * The producer wakes the consumer only if its pool is MEM_POOL_FLAGS_CONCURRENT.
+ *  pStream     ->  Pointer to the stream prepared by mempool_streamInit
+ *  Count       ->  Number of readable bytes wanted
+ *  Timeout     ->  Milliseconds to wait, negative waits forever
+ * Returns number of bytes mempool_streamRead can take, less than Count if
+ * the time ran out
+ ************************************************************************** */
+unsigned long mempool_streamWait(const t_MemStream *const pStream, const unsigned long Count, const long Timeout)
+{
+    struct s_Mem *p_pool = (struct s_Mem *)pStream->pMem;
+    struct timespec deadline;
+    struct timespec *p_deadline = NULL;
+    unsigned long available = 0;
+    uint32_t seq = 0;
+    uint32_t join = 0;
+    int poll = 0;
+
+    available = mempool_streamAvailable(pStream);
+    if((available >= Count) || (Timeout == 0) || !(p_pool->Flags & MEM_POOL_FLAGS_CONCURRENT))
+    {
+        return available;
+    }
+
+    p_deadline = mempool_deadline(&deadline, Timeout);
+    join = mempool_waitJoin(p_pool, MEM_POOL_WAIT_DATA, MEM_POOL_WAIT_DATA_ALL, &poll);
+    do
+    {
+        seq = __atomic_load_n(&p_pool->Wait_Seq, __ATOMIC_ACQUIRE);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        available = mempool_streamAvailable(pStream);
+    } while((available < Count) && mempool_waitFor(p_pool, seq, p_deadline, poll));
+    __atomic_sub_fetch(&p_pool->Wait_Mask, join, __ATOMIC_SEQ_CST);
+
+    return available;
+}
+
+/* **************************************************************************
+ * Function arms events of the pool on an eventfd for poll or epoll loops, the
+ * descriptor is opened on the first call. An armed event makes it readable
+ * once, read it and arm again before retrying the allocation or the read.
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_init
+ *  Events      ->  MEM_POOL_EVENT_FREE and MEM_POOL_EVENT_DATA to be armed
+ * Returns the eventfd, non blocking, -1 if it could not be opened or the pool
+ * is MEM_POOL_FLAGS_SHARED as a descriptor holds in one process only
+ ************************************************************************** */
+int mempool_eventFd(const void *const pMem, const unsigned long Events)
+{
+    struct s_Mem *p_pool = (struct s_Mem *)pMem;
+    int fd = __atomic_load_n(&p_pool->Event_Fd, __ATOMIC_ACQUIRE);
+    int open_fd = -1;
+    uint32_t armed = 0;
+    uint64_t one = 1;
+
+    if(p_pool->Flags & MEM_POOL_FLAGS_SHARED)
+    {
+        return -1;
+    }
+
+#if defined(MEM_POOL_FUTEX)
+    if(fd < 0)
+    {
+        open_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if(open_fd < 0)
+        {
+            return -1;
+        }
+        // Another thread may have opened one meanwhile
+        fd = -1;
+        if(__atomic_compare_exchange_n(&p_pool->Event_Fd, &fd, open_fd, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        {
+            fd = open_fd;
+        }
+        else
+        {
+            (void)close(open_fd);
+        }
+    }
+#else
+    (void)open_fd;
+    return -1;
+#endif
+
+    armed |= (Events & MEM_POOL_EVENT_FREE) ? MEM_POOL_ARMED_FREE : 0u;
+    armed |= (Events & MEM_POOL_EVENT_DATA) ? MEM_POOL_ARMED_DATA : 0u;
+    if(!(__atomic_fetch_or(&p_pool->Wait_Mask, armed | MEM_POOL_WAIT_USED, __ATOMIC_SEQ_CST) & MEM_POOL_WAIT_USED))
+    {
+        // Events racing with the first arming may not be signalled, the caller retries at once
+        if(write(fd, &one, sizeof(one)) != (ssize_t)sizeof(one))
+        {
+            // Counter full, the descriptor is readable anyway
+        }
+    }
+
+    return fd;
+}
+
+/* **************************************************************************
+ * Function closes the eventfd of mempool_eventFd, pools released with
+ * mempool_destroy close it themselves. No other thread may allocate, free or
+ * write a stream on the pool meanwhile, one signalling the eventfd could
+ * write to a descriptor reopened under the same number.
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_init
+ * Returns none.
+ ************************************************************************** */
+void mempool_eventClose(const void *const pMem)
+{
+    struct s_Mem *p_pool = (struct s_Mem *)pMem;
+    int fd = -1;
+
+    // Disarmed first, so notifications from now on leave the descriptor alone
+    __atomic_and_fetch(&p_pool->Wait_Mask, ~(MEM_POOL_ARMED_FREE | MEM_POOL_ARMED_DATA), __ATOMIC_ACQ_REL);
+    fd = __atomic_exchange_n(&p_pool->Event_Fd, -1, __ATOMIC_ACQ_REL);
+    if(fd >= 0)
+    {
+        (void)close(fd);
+    }
 }
+#endif
 
 /* End of mempool.c file */
@@ -25,10 +25,49 @@
 #ifndef __MEM_POOL_H__
 #define __MEM_POOL_H__
 
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MEM_POOL_POSIX                  1
+#include <sys/uio.h>
+#endif
+
 /* **************************************************************************
  *              Macros / Defines
  ************************************************************************** */
-#define MEM_POOL_ALIGN                  4
+#ifndef MEM_POOL_ALIGN
+#define MEM_POOL_ALIGN                  8               // Alignment of header, descriptors and every sector buffer, power of two up to 4096
+#endif
+#if ((MEM_POOL_ALIGN & (MEM_POOL_ALIGN - 1)) != 0) || (MEM_POOL_ALIGN < 8) || (MEM_POOL_ALIGN > 4096)
+#error "MEM_POOL_ALIGN must be a power of two from 8 to 4096"
+#endif
+#ifndef MEM_POOL_CACHE_MAX
+#define MEM_POOL_CACHE_MAX              64              // Upper bound of sectors held by a per thread cache
+#endif
+#ifndef MEM_POOL_CACHE_LINE
+#define MEM_POOL_CACHE_LINE             64              // Cache line size, keeps producer and consumer state apart
+#endif
+#ifndef MEM_POOL_GROUP_MAX
+#define MEM_POOL_GROUP_MAX              8               // Upper bound of sector size classes in a pool group
+#endif
+#ifndef MEM_POOL_HUGE_PAGE
+#define MEM_POOL_HUGE_PAGE              0x200000uL      // Huge page size, mappings with MEM_POOL_FLAGS_HUGETLB are multiples of it
+#endif
+#ifndef MEM_POOL_STAT_STRIPES
+#define MEM_POOL_STAT_STRIPES           8               // Cache lines the byte counters are spread over, threads pick one each
+#endif
+#ifndef MEM_POOL_HIST_BINS
+#define MEM_POOL_HIST_BINS              16              // Power of two buckets of the freed chain length histogram
+#endif
+#ifndef MEM_POOL_PEER_MAX
+#define MEM_POOL_PEER_MAX               15              // Other pools the chains of a pool may continue into, up to 15
+#endif
+#if (MEM_POOL_PEER_MAX < 1) || (MEM_POOL_PEER_MAX > 15)
+#error "MEM_POOL_PEER_MAX must be from 1 to 15, links keep 4 bits of pool slot"
+#endif
+#define MEM_POOL_SECT_LIMIT             0x0FFFFFFEuL    // Upper bound of sectors in a pool, links keep 28 bits of index
+#define MEM_POOL_NOT_FOUND              (~0uL)          // Offset given by mempool_find when the unread data holds no match
 
 /* **************************************************************************
  *              Structures
@@ -47,6 +86,13 @@
             -------------------------------
             |     Sector Descriptor n     |
             -------------------------------
+            |     Chain State 1           |
+            -------------------------------
+            |               .             |
+            |               .             |
+            -------------------------------
+            |     Chain State n           |
+            -------------------------------
             |   Active Memory Sector 1    |
             -------------------------------
             |               .             |
@@ -58,25 +104,123 @@
             -------------------------------
  ************************************************************************** */
 
+typedef struct s_MemCount { /* Byte Counters, one cache line per stripe */
+    unsigned long       Bytes_Written;                  // Bytes stored by the writes of the threads on this stripe
+    unsigned long       Bytes_Read;                     // Bytes returned by the reads of the threads on this stripe
+    char                Pad_Count[MEM_POOL_CACHE_LINE - (2 * sizeof(unsigned long))];
+} t_MemCount;
+
 typedef struct s_Mem {      /* Memory Header */
-    unsigned long       Mem_Desc_Start;
-    unsigned long       Mem_Start;
+    uintptr_t           Mem_Desc_Start;                 // Offset of the descriptors from the header
+    uintptr_t           Mem_Head_Start;                 // Offset of the chain states, sector n has entry n
+    uintptr_t           Mem_Start;                      // Offset of the first sector buffer
     unsigned long       Sec_Cnt;
+    unsigned long       Sec_Min;                        // Growable pool, sectors it never shrinks below
+    unsigned long       Sec_Max;                        // Growable pool, sectors it never grows beyond
+    unsigned long       Grow_Step;                      // Growable pool, sectors added at once
+    unsigned long       Grow_Lock;                      // Growable pool, held while a segment is added
     unsigned long       Sec_Size;
+    unsigned long       Sec_Stride;                     // Distance between sector buffers, Sec_Size rounded up to MEM_POOL_ALIGN
     unsigned long       Total_Memory;
+    unsigned long       Free_Head;                      // Link to the first free sector, 0 when exhausted
+    unsigned long       Flags;
+        #define MEM_POOL_FLAGS_NONE         0x00uL      // Single threaded pool, callers serialize access
+        #define MEM_POOL_FLAGS_CONCURRENT   0x01uL      // Lock-free sector allocation and free from many threads
+        #define MEM_POOL_FLAGS_HUGETLB      0x02uL      // mempool_create, map from the reserved huge page pool
+        #define MEM_POOL_FLAGS_HUGEPAGE     0x04uL      // mempool_create, ask for transparent huge pages
+        #define MEM_POOL_FLAGS_POPULATE     0x08uL      // mempool_create, fault every page in before returning
+        #define MEM_POOL_FLAGS_GROWABLE     0x10uL      // Set by mempool_createGrowable, exhaustion commits another segment
+        #define MEM_POOL_FLAGS_SHARED       0x20uL      // Set by mempool_shmCreate, mapped by several processes at once
+        #define MEM_POOL_FLAGS_MAPPED       0x80uL      // Set by mempool_create, pool is released by mempool_destroy
+    char                Pad_Top[MEM_POOL_CACHE_LINE];
+    unsigned long long  Free_Top;                       // Concurrent free list, ABA tag (high 32 bits) | sector index + 1
+    char                Pad_Free[MEM_POOL_CACHE_LINE];
+    t_MemCount          Bytes[MEM_POOL_STAT_STRIPES];   // Bytes written and read, summed by mempool_stats
+    size_t              Map_Size;                       // Length of the mapping made by mempool_create, 0 otherwise
+    uint32_t            Wait_Seq;                       // Bumped to wake threads in mempool_allocWait and mempool_streamWait
+    uint32_t            Wait_Mask;                      // Threads waiting per event and events armed on Event_Fd, 0 until used
+    int                 Event_Fd;                       // Descriptor of mempool_eventFd, -1 until it is asked for
+        #define MEM_POOL_EVENT_FREE         0x01uL      // A sector went back to the free list
+        #define MEM_POOL_EVENT_DATA         0x02uL      // A stream producer published data
+    unsigned long       Sect_Used;                      // Sectors off the free list
+    unsigned long       Sect_High;                      // High water mark of Sect_Used
+    unsigned long       Alloc_Fail;                     // Allocations refused because the pool was exhausted
+    unsigned long       Alloc_Extend;                   // Sectors chained on to grow a buffer
+    unsigned long       Chain_Hist[MEM_POOL_HIST_BINS]; // Freed chains, bin n counts 2^n up to 2^(n+1) - 1 sectors
+    struct s_Mem        *pPeer[MEM_POOL_PEER_MAX];      // Pools reached by links of slot 1 onwards, filled on first use, never on shared pools
 } t_Mem;
 
-typedef struct s_MemSect {  /* Sector Descriptor */
-    unsigned long       Flags;
+typedef struct s_MemSect {  /* Sector Descriptor, all a walk along a chain or the free list touches */
+    uint32_t            Flags;
         #define MEMSECT_FLAGS_NONE          0x00uL      // Buffer is free can be allocated for future use
         #define MEMSECT_FLAGS_USED          0x01uL      // Buffer already allocated
         #define MEMSECT_FLAGS_CONCAT        0x10uL      // Concatenated buffer i.e. data is divided in to multiple of them
-    struct s_MemSect    *pNext;                         // Linked list pointer
-    struct s_MemSect    *pConcat;                       // Next concatenation
-    void                *pMemSect;                      // Start of allocated memory
+        #define MEMSECT_FLAGS_RECLAIM       0x20uL      // Head only, sectors fully read are returned to the pool
+        #define MEMSECT_FLAGS_LISTED        0x40uL      // Free list member, only while mempool_shrink runs
+        #define MEMSECT_FLAGS_SPLICED       0x80uL      // Head only, some sector of the chain ends short by its Gap
+        #define MEMSECT_FLAGS_CLONE         0x100uL     // Head only, made by mempool_clone, holds no data and reads shared sectors
+        #define MEMSECT_FLAGS_OBJ           0x200uL     // Object of mempool_objAlloc, the only sectors mempool_objFree takes
+        #define MEMSECT_FLAGS_REF           0x10000uL   // One reference beyond the first, taken by each clone linking to the sector
+        #define MEMSECT_FLAGS_REFS          0xFFFF0000uL// References beyond the first, the sector and all after it stay allocated
+    uint32_t            Self;                           // Index in the owning pool, gives pool, buffer and chain state
+    uint32_t            Concat;                         // Link to the next concatenation, next free sector while unallocated
+    uint32_t            Gap;                            // Bytes left unused at the end by mempool_splice, 0 for a full sector
+} t_MemSect;
+
+typedef struct s_MemHead {  /* Chain State, meaningful while the sector heads a chain */
     unsigned long       ReadIndex;                      // Read index
     unsigned long       WriteIndex;                     // Write index
-} t_MemSect;
+    unsigned long       WriteBase;                      // Write index at which the Write sector starts
+    unsigned long       ReadBase;                       // Read index at which the Read sector starts
+    uint32_t            Write;                          // Link to the sector holding the write index
+    uint32_t            Read;                           // Link to the sector holding the read index
+} t_MemHead;
+
+typedef struct s_MemStats { /* Pool Counters Snapshot */
+    unsigned long       Sect_Cnt;                       // Sectors in the pool
+    unsigned long       Sect_Size;                      // Bytes per sector
+    unsigned long       Sect_Used;                      // Sectors currently off the free list
+    unsigned long       Sect_High;                      // Most sectors ever off the free list at once
+    unsigned long       Alloc_Fail;                     // Allocations refused because the pool was exhausted
+    unsigned long       Alloc_Extend;                   // Sectors chained on to grow a buffer
+    unsigned long       Bytes_Written;                  // Bytes stored by all writes
+    unsigned long       Bytes_Read;                     // Bytes returned by all reads
+    unsigned long       Chain_Hist[MEM_POOL_HIST_BINS]; // Freed chains, bin n counts 2^n up to 2^(n+1) - 1 sectors
+} t_MemStats;
+
+typedef struct s_MemCache { /* Per Thread Sector Cache */
+    void                *pMem;                          // Pool the cached sectors are taken from
+    unsigned long       Size;                           // Sectors kept before spilling back to the pool
+    unsigned long       Batch;                          // Sectors moved from or to the pool at once
+    unsigned long       Count;                          // Sectors currently cached
+    void                *pSect[MEM_POOL_CACHE_MAX];     // Cached free sector descriptors
+} t_MemCache;
+
+typedef struct s_MemGroup { /* Sector Size Classes */
+    unsigned long       Pool_Cnt;                       // Number of size classes
+    void                *pMem[MEM_POOL_GROUP_MAX];      // Pools sorted by ascending sector size
+} t_MemGroup;
+
+typedef struct s_MemStream { /* Single Producer Single Consumer Stream */
+    void                *pMem;                          // Producer, pool the chain grows from
+    struct s_MemSect    *pWrite;                        // Producer, sector holding the write index
+    unsigned long       WriteBase;                      // Producer, write index at which pWrite starts
+    unsigned long       WriteIndex;                     // Producer, published with release ordering
+    char                Pad_Write[MEM_POOL_CACHE_LINE];
+    struct s_MemSect    *pHead;                         // Consumer, first sector of the chain
+    struct s_MemSect    *pRead;                         // Consumer, sector holding the read index
+    unsigned long       ReadBase;                       // Consumer, read index at which pRead starts
+    unsigned long       ReadIndex;                      // Consumer, published with release ordering
+    unsigned long       Reclaim;                        // Consumer, non zero releases sectors fully read
+    char                Pad_Read[MEM_POOL_CACHE_LINE];
+} t_MemStream;
+
+typedef struct s_MemRecIter { /* Record Iterator */
+    struct s_MemSect    *pSect;                         // Sector holding Index
+    unsigned long       Base;                           // Index at which pSect starts
+    unsigned long       Index;                          // Start of the next record
+    unsigned long       End;                            // Write index when the iteration started
+} t_MemRecIter;
 
 /* **************************************************************************
  *              Memory Heap Declarations - Do not move this section
@@ -86,10 +230,12 @@ typedef struct s_MemSect {  /* Sector Descriptor */
 #define MEM_POOL_SIZE(Name)                             (unsigned long)sizeof(MEM_POOL_NAME(Name))
 #define MEM_POOL_SECT_CNT(Name)                         mem_sect_##Name
 #define MEM_POOL_SECT_SIZE(Name)                        mem_sect_size_##Name
+#define MEM_POOL_ROUND(Size)                            ( ( (size_t)(Size) + ( MEM_POOL_ALIGN - 1 ) ) & ~( (size_t)MEM_POOL_ALIGN - 1 ) )
+#define MEM_POOL_BYTES(Sectors, Bytes)                  ( MEM_POOL_ROUND( sizeof(t_Mem) ) + MEM_POOL_ROUND( (Sectors) * sizeof(t_MemSect) ) +\
+                                                                    MEM_POOL_ROUND( (Sectors) * sizeof(t_MemHead) ) +\
+                                                                    ( (Sectors) * MEM_POOL_ROUND( Bytes ) ) + ( MEM_POOL_ALIGN - 1 ) )
 #define MEM_POOL_CREATE(Name, Size)                     char Name[Size];
-#define MEM_POOL_DECLARE(Name, Sectors, Bytes)          MEM_POOL_CREATE( mem_##Name, ( ( ( (sizeof(t_Mem) +\
-                                                                    ( Sectors * ( sizeof(t_MemSect) + Bytes ) ) ) + ( MEM_POOL_ALIGN - 1 ) ) ) &\
-                                                                    ( ~( MEM_POOL_ALIGN - 1) ) ) ); \
+#define MEM_POOL_DECLARE(Name, Sectors, Bytes)          MEM_POOL_CREATE( mem_##Name, MEM_POOL_BYTES( Sectors, Bytes ) ); \
                                                             unsigned long mem_sect_##Name = Sectors;\
                                                             unsigned long mem_sect_size_##Name = Bytes;
 
@@ -97,6 +243,9 @@ typedef struct s_MemSect {  /* Sector Descriptor */
 /* **************************************************************************
  *              Global Function Proto-types
  ************************************************************************** */
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 /* **************************************************************************
  * Function initializes the memory section for future use
@@ -104,17 +253,55 @@ typedef struct s_MemSect {  /* Sector Descriptor */
  *  Size        ->  Size of memory fetched using MEM_POOL_SIZE(Name) macro
  *  SectCnt     ->  Number of Sectors of memory blocks fetched using MEM_POOL_CNT(Name) macro
  *  SectSize    ->  Size of memory sector fetched using MEM_POOL_SECT_SIZE(Name) macro
- * Returns the start address of the current initialized Heap.
+ * Returns the start address of the current initialized Heap, pMem rounded up
+ * to MEM_POOL_ALIGN, which every other call takes as the pool. NULL if Size
+ * is short of MEM_POOL_BYTES, SectCnt exceeds MEM_POOL_SECT_LIMIT or SectSize
+ * is zero or exceeds 32 bits.
  ************************************************************************** */
 void *mempool_init(const void *const pMem, const unsigned long Size, const unsigned long SectCnt, const unsigned long SectSize);
 
+/* **************************************************************************
+ * Function initializes the memory section with pool wide behaviour flags
+ *  pMem        ->  Pointer to the memory fetched using MEM_POOL_ADDR(Name) macro
+ *  Size        ->  Size of memory fetched using MEM_POOL_SIZE(Name) macro
+ *  SectCnt     ->  Number of Sectors of memory blocks fetched using MEM_POOL_CNT(Name) macro
+ *  SectSize    ->  Size of memory sector fetched using MEM_POOL_SECT_SIZE(Name) macro
+ *  Flags       ->  MEM_POOL_FLAGS_CONCURRENT lets mempool_alloc and mempool_free
+ *                  be called from several threads at once without a lock,
+ *                  MEM_POOL_FLAGS_NONE behaves as mempool_init
+ * Returns the start address of the current initialized Heap, pMem rounded up
+ * to MEM_POOL_ALIGN, which every other call takes as the pool. NULL if Size
+ * is short of MEM_POOL_BYTES, SectCnt exceeds MEM_POOL_SECT_LIMIT or SectSize
+ * is zero or exceeds 32 bits.
+ ************************************************************************** */
+void *mempool_initWithFlags(const void *const pMem, const unsigned long Size, const unsigned long SectCnt,\
+                                const unsigned long SectSize, const unsigned long Flags);
+
 /* **************************************************************************
  * Function allocates the unallocated memory sector for the user
- *  pMem        ->  Pointer to the top of Heap memory fetched using MEM_POOL_ADDR(Name) macro
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_init
  * Returns the Sector Pointer if available else returns NULL
  ************************************************************************** */
 void *mempool_alloc(const void *const pMem);
 
+/* **************************************************************************
+ * Function allocates Count sectors at once, either all of them or none
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_init
+ *  ppMemSect   ->  Array receiving the Sector Pointers
+ *  Count       ->  Number of sectors wanted
+ * Returns Count if all sectors are allocated, zero otherwise or for no sectors
+ ************************************************************************** */
+unsigned long mempool_allocBulk(const void *const pMem, void **const ppMemSect, const unsigned long Count);
+
+/* **************************************************************************
+ * Function frees several allocated sector chains at once, sectors of the
+ * same pool go back to the free list with a single push
+ *  ppMemSect   ->  Array of memory sector start descriptors, NULL entries skipped
+ *  Count       ->  Number of entries in the array
+ * Returns none.
+ ************************************************************************** */
+void mempool_freeBulk(void *const *const ppMemSect, const unsigned long Count);
+
 /* **************************************************************************
  * Function frees the allocated sector
  *  pMemSect    ->  Pointer to memory sector descriptor which needs to be marked
@@ -123,6 +310,43 @@ void *mempool_alloc(const void *const pMem);
  ************************************************************************** */
 void mempool_free(const void *const pMemSect);
 
+/* **************************************************************************
+ * Function allocates a sector as a fixed size object, the sector buffer is
+ * handed out directly and no read or write index is kept for it
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_init
+ * Returns pointer to the object, MEM_POOL_ALIGN aligned and Sec_Size bytes
+ * long, NULL if the pool is exhausted
+ ************************************************************************** */
+void *mempool_objAlloc(const void *const pMem);
+
+/* **************************************************************************
+ * Function frees an object of mempool_objAlloc, its descriptor is found from
+ * the object address relative to Mem_Start
+ *  pMem        ->  Pointer to the top of Heap memory the object came from
+ *  pObj        ->  Pointer to the object, NULL and pointers that are not an
+ *                  object of the pool in use, such as chain buffers, are ignored
+ * Returns none.
+ ************************************************************************** */
+void mempool_objFree(const void *const pMem, const void *const pObj);
+
+/* **************************************************************************
+ * Function turns a sector handle into a number valid in every mapping of the
+ * pool, for passing a chain to another process sharing it
+ *  pMem        ->  Pointer to the top of Heap memory the sector belongs to
+ *  pMemSect    ->  Pointer to memory sector start descriptor
+ * Returns the sector number, zero for NULL
+ ************************************************************************** */
+unsigned long mempool_sectHandle(const void *const pMem, const void *const pMemSect);
+
+/* **************************************************************************
+ * Function turns a sector number of mempool_sectHandle back into a sector
+ * handle valid in the mapping of the pool given
+ *  pMem        ->  Pointer to the top of Heap memory as mapped by the caller
+ *  Handle      ->  Sector number
+ * Returns the Sector Pointer, NULL if the number is out of the pool
+ ************************************************************************** */
+void *mempool_handleSect(const void *const pMem, const unsigned long Handle);
+
 /* **************************************************************************
  * Function used for reading data from the memory, everytime you read data
  * the read pointer is incremented
@@ -147,7 +371,9 @@ unsigned long mempool_readFull(const void *const pMemSect, void *pTarget, const
 
 /* **************************************************************************
  * Function writes data to allocated buffer or adds data to new buffer allocation
- *  pMem        ->  Pointer to the memory fetched using MEM_POOL_ADDR(Name) macro
+ * A sector chain must only be written by one thread at a time, additional
+ * sectors are taken from the pool the same way as mempool_alloc
+ *  pMem        ->  Pointer to the memory returned by mempool_init
  *  pMemSect    ->  Pointer to memory sector descriptor where data is to be written
  *  pSouce      ->  Pointer to source buffer from where data needs to be read
  *  SrcSize     ->  Length of the data to be written
@@ -157,12 +383,32 @@ unsigned long mempool_writeToIndex(const void *const pMem, const void *const pMe
                                     const char *const pSource, const unsigned long SrcSize);
 
 /* **************************************************************************
- * Function resets write and read pointers of the allocated memory
+ * Function resets write and read pointers of the allocated memory, a chain
+ * with clones is left as it is until they are freed
  *  pMemSect    ->  Pointer to memory sectors start descriptor who needs to be resetted
  * Returns none.
  ************************************************************************** */
 void mempool_resetMemory(const void *const pMemSect);
 
+/* **************************************************************************
+ * Function resets write and read pointers of the allocated memory and returns
+ * every concatenated sector to the pool, leaving only the head sector. A chain
+ * with clones is left as it is, a clone drops its share of the data.
+ *  pMemSect    ->  Pointer to memory sectors start descriptor who needs to be resetted
+ * Returns none.
+ ************************************************************************** */
+void mempool_resetTrim(const void *const pMemSect);
+
+/* **************************************************************************
+ * Function switches a chain to reclaim mode, every read then returns sectors
+ * fully read back to the pool so a long lived chain only holds unread data,
+ * the head sector and at most the sector being read
+ *  pMemSect    ->  Pointer to memory sector start descriptor
+ *  Enable      ->  Non zero to release consumed sectors while reading
+ * Returns none.
+ ************************************************************************** */
+void mempool_reclaimMode(const void *const pMemSect, const unsigned long Enable);
+
 /* **************************************************************************
  * Function lets you know how much data can be extracted during next read cycle
  *  pMemSect    ->  Pointer to memory sector start descriptor
@@ -171,17 +417,459 @@ void mempool_resetMemory(const void *const pMemSect);
 unsigned long mempool_availableData(const void *const pMemSect);
 
 /* **************************************************************************
- * Function counts number of used memory sectors
- *  pMem        ->  Pointer to the top of Heap memory fetched using MEM_POOL_ADDR(Name) macro
+ * Function counts number of used memory sectors, sectors held by a per thread
+ * cache count as used until they are flushed back to the pool
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_init
  * Returns currently allocated sectors.
  ************************************************************************** */
 unsigned long mempool_sectUsed(const void *const pMem);
 
+/* **************************************************************************
+ * Function takes a snapshot of the pool counters kept by the hot paths, on a
+ * concurrent pool each counter is exact but they are not read at one instant
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_init
+ *  pStats      ->  Pointer to the structure receiving the counters
+ * Returns none.
+ ************************************************************************** */
+void mempool_stats(const void *const pMem, t_MemStats *const pStats);
+
 /* **************************************************************************
  * Function responds with percentage of memory used out of allocated on RAM
- *  pMem        ->  Pointer to the top of Heap memory fetched using MEM_POOL_ADDR(Name) macro
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_init
  * Returns percentage of active usable memory (double type)
  ************************************************************************** */
 double mempool_activeSection(const void *const pMem);
 
+/* **************************************************************************
+ * Function prepares a per thread sector cache in front of a pool. Sectors held
+ * by a cache stay marked free but no other thread gets them until flushed, the
+ * pool counts them as used meanwhile
+ *  pCache      ->  Pointer to the cache, usually a thread local variable
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_init
+ *  CacheSize   ->  Sectors kept before spilling back to the pool, up to MEM_POOL_CACHE_MAX
+ *  BatchSize   ->  Sectors moved from or to the pool at once, up to CacheSize
+ * Returns none.
+ ************************************************************************** */
+void mempool_cacheInit(t_MemCache *const pCache, const void *const pMem, const unsigned long CacheSize, const unsigned long BatchSize);
+
+/* **************************************************************************
+ * Function allocates a sector from the per thread cache, refilling the cache
+ * with a batch of sectors from the pool when it runs dry
+ *  pCache      ->  Pointer to the cache prepared by mempool_cacheInit
+ * Returns the Sector Pointer if available else returns NULL
+ ************************************************************************** */
+void *mempool_cacheAlloc(t_MemCache *const pCache);
+
+/* **************************************************************************
+ * Function frees the allocated sector chain into the per thread cache, a batch
+ * of sectors is returned to the pool whenever the cache overflows
+ *  pCache      ->  Pointer to the cache prepared by mempool_cacheInit
+ *  pMemSect    ->  Pointer to memory sector descriptor which needs to be marked
+ *                  free for the future use.
+ * Returns none.
+ ************************************************************************** */
+void mempool_cacheFree(t_MemCache *const pCache, const void *const pMemSect);
+
+/* **************************************************************************
+ * Function returns every cached sector to the pool, call before the owning
+ * thread exits or when the pool counters have to be exact
+ *  pCache      ->  Pointer to the cache prepared by mempool_cacheInit
+ * Returns none.
+ ************************************************************************** */
+void mempool_cacheFlush(t_MemCache *const pCache);
+
+/* **************************************************************************
+ * Function groups pools of different sector sizes, allocations are routed to
+ * the smallest sector size class fitting the request
+ *  pGroup      ->  Pointer to the pool group to be prepared
+ *  ppMem       ->  Array of initialized pools, any order
+ *  PoolCnt     ->  Number of pools in the array, up to MEM_POOL_GROUP_MAX
+ * Returns number of pools taken in the group.
+ ************************************************************************** */
+unsigned long mempool_groupInit(t_MemGroup *const pGroup, void *const *const ppMem, const unsigned long PoolCnt);
+
+/* **************************************************************************
+ * Function allocates a sector from the best fitting size class of the group,
+ * a larger class is used when the best one is exhausted and a smaller one
+ * when all larger classes are exhausted as well
+ *  pGroup      ->  Pointer to the pool group prepared by mempool_groupInit
+ *  Size        ->  Number of bytes expected to be stored
+ * Returns the Sector Pointer if available else returns NULL
+ ************************************************************************** */
+void *mempool_groupAlloc(const t_MemGroup *const pGroup, const unsigned long Size);
+
+/* **************************************************************************
+ * Function writes data to the chain growing it with sectors of a pool group,
+ * each added sector is the best fit for the data left to be written but
+ * never smaller than the sector it follows. Chain is read and freed with
+ * the regular functions.
+ *  pGroup      ->  Pointer to the pool group prepared by mempool_groupInit
+ *  pMemSect    ->  Pointer to memory sector descriptor where data is to be written
+ *  pSouce      ->  Pointer to source buffer from where data needs to be read
+ *  SrcSize     ->  Length of the data to be written
+ * Returns number of bytes written to the memory sector.
+ ************************************************************************** */
+unsigned long mempool_groupWrite(const t_MemGroup *const pGroup, const void *const pMemSect,\
+                                    const char *const pSource, const unsigned long SrcSize);
+
+#if defined(MEM_POOL_POSIX)
+/* **************************************************************************
+ * Function describes the unread data of the chain as a scatter/gather list
+ * without copying, the read index is not moved
+ *  pMemSect    ->  Pointer to memory sector start descriptor
+ *  pIov        ->  Array of iovec to be filled, ready for writev or sendmsg
+ *  IovCnt      ->  Number of entries in the array
+ * Returns number of iovec entries filled, zero if no data to be read
+ ************************************************************************** */
+unsigned long mempool_readIovec(const void *const pMemSect, struct iovec *const pIov, const unsigned long IovCnt);
+
+/* **************************************************************************
+ * Function moves the read index forward after data has been used in place,
+ * for example after a partial writev of the mempool_readIovec list
+ *  pMemSect    ->  Pointer to memory sector start descriptor
+ *  Count       ->  Number of bytes consumed
+ * Returns number of bytes the read index moved, limited to the unread data
+ ************************************************************************** */
+unsigned long mempool_readConsume(const void *const pMemSect, const unsigned long Count);
+
+/* **************************************************************************
+ * Function describes free space after the write index as a scatter/gather
+ * list, sectors are allocated and concatenated until Size bytes are covered
+ * or the pool is exhausted. The write index is not moved.
+ *  pMem        ->  Pointer to the memory returned by mempool_init
+ *  pMemSect    ->  Pointer to memory sector start descriptor
+ *  pIov        ->  Array of iovec to be filled, ready for readv or recvmsg
+ *  IovCnt      ->  Number of entries in the array
+ *  Size        ->  Number of bytes of free space wanted
+ * Returns number of iovec entries filled, zero if no space available
+ ************************************************************************** */
+unsigned long mempool_writeIovec(const void *const pMem, const void *const pMemSect, struct iovec *const pIov,\
+                                    const unsigned long IovCnt, const unsigned long Size);
+#endif
+
+/* **************************************************************************
+ * Function reserves contiguous free space at the write index for a producer
+ * encoding in place, a sector is allocated and concatenated when the one at
+ * the write index is full. Data becomes readable with mempool_writeCommit.
+ *  pMem        ->  Pointer to the memory returned by mempool_init
+ *  pMemSect    ->  Pointer to memory sector start descriptor
+ *  pLength     ->  Receives the number of contiguous bytes reserved
+ * Returns pointer to the reserved space, NULL if the pool is exhausted
+ ************************************************************************** */
+void *mempool_writeReserve(const void *const pMem, const void *const pMemSect, unsigned long *const pLength);
+
+/* **************************************************************************
+ * Function moves the write index forward after data has been produced in
+ * place, for example after readv into the mempool_writeIovec list
+ *  pMemSect    ->  Pointer to memory sector start descriptor
+ *  Count       ->  Number of bytes produced
+ * Returns number of bytes the write index moved, limited to the sectors
+ * already concatenated to the chain
+ ************************************************************************** */
+unsigned long mempool_writeCommit(const void *const pMemSect, const unsigned long Count);
+
+/* **************************************************************************
+ * Function turns an allocated sector chain into a byte pipe between exactly
+ * one producer thread and one consumer thread, neither side takes a lock.
+ * The pool needs MEM_POOL_FLAGS_CONCURRENT when other threads use it as well.
+ * Chain is released with mempool_free on pHead once both sides are done.
+ *  pStream     ->  Pointer to the stream to be prepared
+ *  pMem        ->  Pointer to the memory the producer grows the chain from
+ *  pMemSect    ->  Pointer to memory sector start descriptor, data already
+ *                  written and not read is carried over
+ * Returns none.
+ ************************************************************************** */
+void mempool_streamInit(t_MemStream *const pStream, const void *const pMem, const void *const pMemSect);
+
+/* **************************************************************************
+ * Function appends data to the stream, producer thread only
+ *  pStream     ->  Pointer to the stream prepared by mempool_streamInit
+ *  pSource     ->  Pointer to source buffer from where data needs to be read
+ *  SrcSize     ->  Length of the data to be written
+ * Returns number of bytes written, less than SrcSize if the pool is exhausted
+ ************************************************************************** */
+unsigned long mempool_streamWrite(t_MemStream *const pStream, const char *const pSource, const unsigned long SrcSize);
+
+/* **************************************************************************
+ * Function takes data out of the stream, consumer thread only
+ *  pStream     ->  Pointer to the stream prepared by mempool_streamInit
+ *  pTarget     ->  Pointer to target buffer
+ *  TargetSize  ->  Size of the target buffer
+ * Returns number of bytes copied to target buffer, zero if no data available
+ ************************************************************************** */
+unsigned long mempool_streamRead(t_MemStream *const pStream, void *pTarget, const unsigned long TargetSize);
+
+/* **************************************************************************
+ * Function lets the consumer return sectors it has fully read to the pool, the
+ * first sector of the chain then moves along and is found in pHead. The pool
+ * needs MEM_POOL_FLAGS_CONCURRENT as producer and consumer both touch its
+ * free list, on other pools reclaim stays off.
+ *  pStream     ->  Pointer to the stream prepared by mempool_streamInit
+ *  Enable      ->  Non zero to release consumed sectors while reading
+ * Returns non zero if reclaim is on, zero when refused for the pool.
+ ************************************************************************** */
+unsigned long mempool_streamReclaim(t_MemStream *const pStream, const unsigned long Enable);
+
+/* **************************************************************************
+ * Function lets the consumer know how much data the producer published
+ *  pStream     ->  Pointer to the stream prepared by mempool_streamInit
+ * Returns number of bytes can be read by next mempool_streamRead.
+ ************************************************************************** */
+unsigned long mempool_streamAvailable(const t_MemStream *const pStream);
+
+/* **************************************************************************
+ * Function appends a record to the chain, the length goes first as a varint
+ * of seven bits per byte followed by the data. A record is stored whole or
+ * not at all.
+ *  pMem        ->  Pointer to the memory returned by mempool_init
+ *  pMemSect    ->  Pointer to memory sector start descriptor
+ *  pSource     ->  Pointer to the record data
+ *  SrcSize     ->  Length of the record data
+ * Returns number of bytes stored including the length, zero if the pool is
+ * exhausted
+ ************************************************************************** */
+unsigned long mempool_recordWrite(const void *const pMem, const void *const pMemSect, const void *const pSource,\
+                                    const unsigned long SrcSize);
+
+/* **************************************************************************
+ * Function takes the record at the read index out of the chain
+ *  pMemSect    ->  Pointer to memory sector start descriptor
+ *  pTarget     ->  Pointer to target buffer
+ *  TargetSize  ->  Size of the target buffer
+ *  pLength     ->  Receives the record length, zero if no complete record is
+ *                  written yet, the size needed if it does not fit pTarget
+ * Returns number of bytes the read index moved, length prefix included, so an
+ * empty record gives its prefix size, zero if the record is left in the chain
+ ************************************************************************** */
+unsigned long mempool_recordRead(const void *const pMemSect, void *const pTarget, const unsigned long TargetSize,\
+                                    unsigned long *const pLength);
+
+/* **************************************************************************
+ * Function starts an iteration over the records between the read and the
+ * write index, the chain is not changed by iterating
+ *  pIter       ->  Pointer to the iterator to be prepared
+ *  pMemSect    ->  Pointer to memory sector start descriptor
+ * Returns none.
+ ************************************************************************** */
+void mempool_recordIterInit(t_MemRecIter *const pIter, const void *const pMemSect);
+
+/* **************************************************************************
+ * Function gives the next record of an iteration, in place when it lies in
+ * one sector, copied to the scratch buffer when it crosses into the next one
+ *  pIter       ->  Pointer to the iterator prepared by mempool_recordIterInit
+ *  pScratch    ->  Buffer for records crossing a sector, may be NULL
+ *  ScratchSize ->  Size of the scratch buffer
+ *  pLength     ->  Receives the record length, zero at the end of the records
+ * Returns pointer to the record, NULL at the end or when a crossing record
+ * does not fit the scratch buffer, *pLength tells the size needed and the
+ * iterator stays on that record
+ ************************************************************************** */
+const void *mempool_recordNext(t_MemRecIter *const pIter, void *const pScratch, const unsigned long ScratchSize,\
+                                    unsigned long *const pLength);
+
+/* **************************************************************************
+ * Function drops every record an iteration has returned, the read index
+ * moves to the iterator. In reclaim mode sectors may go back to the pool,
+ * iterate again from mempool_recordIterInit afterwards.
+ *  pMemSect    ->  Pointer to memory sector start descriptor
+ *  pIter       ->  Pointer to an iterator over the same chain
+ * Returns number of bytes the read index moved.
+ ************************************************************************** */
+unsigned long mempool_recordConsume(const void *const pMemSect, const t_MemRecIter *const pIter);
+
+/* **************************************************************************
+ * Function moves the unread data of one chain to the end of another. Only the
+ * unread part of the source read sector is copied, the sectors after it are
+ * relinked to the destination and the sector they follow keeps the bytes
+ * past its data as a gap. The source is left empty with its head sector and
+ * both chains are freed as usual afterwards. Not for chains of a stream.
+ *  pMem        ->  Pointer to the memory the destination grows from for the copy
+ *  pDstSect    ->  Pointer to memory sector start descriptor receiving the data
+ *  pSrcSect    ->  Pointer to memory sector start descriptor giving the data
+ * Returns number of bytes moved, fewer than were unread if the pool is exhausted
+ ************************************************************************** */
+unsigned long mempool_splice(const void *const pMem, const void *const pDstSect, const void *const pSrcSect);
+
+/* **************************************************************************
+ * Function makes a new chain sharing the data of another, the clone has its
+ * own read index starting at the read index of the original. Its head sector
+ * holds no data, it links to the original head which takes a reference, and
+ * the shared sectors go back to the pool when the last of the chains is
+ * freed. Both chains are read only and not reclaimed meanwhile, a clone
+ * gives its share up with mempool_resetTrim. Not for chains of a stream.
+ *  pMemSect    ->  Pointer to memory sector start descriptor to be cloned
+ * Returns the Sector Pointer of the clone, NULL if the pool is exhausted or
+ * the head already holds the most references
+ ************************************************************************** */
+void *mempool_clone(const void *const pMemSect);
+
+/* **************************************************************************
+ * Function looks for a pattern in the unread data, the sectors are scanned
+ * in place from the read index on and a match may cross sector boundaries.
+ * Neither index moves, reading as many bytes as the result gives stops the
+ * read index right before the match.
+ *  pMemSect    ->  Pointer to memory sector start descriptor to be scanned
+ *  pPattern    ->  Pointer to the pattern
+ *  PatternSize ->  Bytes of the pattern
+ * Returns offset of the first match from the read index, MEM_POOL_NOT_FOUND
+ * if the unread data holds none
+ ************************************************************************** */
+unsigned long mempool_findPattern(const void *const pMemSect, const void *const pPattern, const unsigned long PatternSize);
+
+/* **************************************************************************
+ * Function looks for a byte in the unread data, such as the delimiter ending
+ * a line, see mempool_findPattern
+ *  pMemSect    ->  Pointer to memory sector start descriptor to be scanned
+ *  Byte        ->  Byte to be found
+ * Returns offset of the first such byte from the read index,
+ * MEM_POOL_NOT_FOUND if the unread data holds none
+ ************************************************************************** */
+unsigned long mempool_find(const void *const pMemSect, const unsigned char Byte);
+
+#if defined(MEM_POOL_POSIX)
+/* **************************************************************************
+ * Function maps a pool sized at run time and initializes it, for pools too
+ * large or too late known for MEM_POOL_DECLARE
+ *  SectCnt     ->  Number of sectors of the pool
+ *  SectSize    ->  Size of each memory sector
+ *  Flags       ->  MEM_POOL_FLAGS_CONCURRENT as for mempool_initWithFlags, and
+ *                  MEM_POOL_FLAGS_HUGETLB maps explicit huge pages, falls
+ *                  back to base pages when none are reserved
+ *                  MEM_POOL_FLAGS_HUGEPAGE asks for transparent huge pages
+ *                  MEM_POOL_FLAGS_POPULATE faults every page in up front
+ * Returns the start address of the initialized Heap, NULL if the pool size
+ * wraps around, a sector is empty or exceeds 32 bits or mapping failed
+ ************************************************************************** */
+void *mempool_create(const unsigned long SectCnt, const unsigned long SectSize, const unsigned long Flags);
+
+/* **************************************************************************
+ * Function maps a pool able to grow, address space for SectMax sectors is
+ * reserved up front but only SectCnt of them are backed by memory. When the
+ * free list runs dry allocation and chain extension commit GrowStep more.
+ *  SectCnt     ->  Number of sectors usable from the start, the pool never
+ *                  shrinks below it
+ *  SectMax     ->  Upper bound of sectors the pool grows to
+ *  GrowStep    ->  Number of sectors added at once
+ *  SectSize    ->  Size of each memory sector
+ *  Flags       ->  MEM_POOL_FLAGS_CONCURRENT as for mempool_initWithFlags,
+ *                  MEM_POOL_FLAGS_HUGEPAGE asks for transparent huge pages
+ * Returns the start address of the initialized Heap, NULL if the pool size
+ * wraps around, a sector is empty or exceeds 32 bits or mapping failed
+ ************************************************************************** */
+void *mempool_createGrowable(const unsigned long SectCnt, const unsigned long SectMax, const unsigned long GrowStep,\
+                                const unsigned long SectSize, const unsigned long Flags);
+
+/* **************************************************************************
+ * Function lays a concurrent pool out in a shared memory object, every
+ * process mapping the object with mempool_shmAttach sees the same pool. All
+ * addresses kept in the pool are relative to it, so mappings may sit at
+ * different addresses. Chains pass between processes as mempool_sectHandle.
+ *  Fd          ->  Descriptor of a shared memory object, from shm_open or
+ *                  memfd_create, it is resized to fit the pool
+ *  SectCnt     ->  Number of sectors
+ *  SectSize    ->  Size of each memory sector
+ *  Flags       ->  MEM_POOL_FLAGS_POPULATE faults every page in before returning
+ * Returns the start address of the pool in this process, NULL if sizing or
+ * mapping failed
+ ************************************************************************** */
+void *mempool_shmCreate(const int Fd, const unsigned long SectCnt, const unsigned long SectSize, const unsigned long Flags);
+
+/* **************************************************************************
+ * Function maps a pool laid out by mempool_shmCreate into this process,
+ * mempool_destroy removes the mapping again
+ *  Fd          ->  Descriptor of the shared memory object holding the pool
+ * Returns the start address of the pool in this process, NULL if the object
+ * holds no shared pool
+ ************************************************************************** */
+void *mempool_shmAttach(const int Fd);
+
+/* **************************************************************************
+ * Function writes the pool as it is to a file, header, descriptors, chain
+ * states and sector buffers in one image followed by a versioned trailer with
+ * a checksum of the metadata. Nothing may change the pool meanwhile. Growable
+ * pools and pools whose chains continue into other pools are refused.
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_init
+ *  pPath       ->  File to be written, replaced once the image is complete
+ * Returns number of bytes written, zero if failed
+ ************************************************************************** */
+unsigned long mempool_snapshot(const void *const pMem, const char *const pPath);
+
+/* **************************************************************************
+ * Function maps a file written by mempool_snapshot as a private copy of the
+ * pool, every chain allocated at the time of the snapshot is readable again
+ * through mempool_handleSect. Only the metadata is verified, sector buffers
+ * are paged in when first touched, so restore time does not depend on the
+ * data held. The pool is released by mempool_destroy.
+ *  pPath       ->  File written by mempool_snapshot
+ * Returns the start address of the restored pool, NULL if the file is not a
+ * snapshot of this build or fails its checksum
+ ************************************************************************** */
+void *mempool_restore(const char *const pPath);
+
+/* **************************************************************************
+ * Function returns the idle segments at the end of a growable pool to the
+ * system, down to the sectors the pool was created with. Nothing else may use
+ * the pool meanwhile and per thread caches of it must be flushed first.
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_createGrowable
+ * Returns number of sectors released.
+ ************************************************************************** */
+unsigned long mempool_shrink(const void *const pMem);
+
+/* **************************************************************************
+ * Function unmaps a pool made by mempool_create, mempool_createGrowable,
+ * mempool_shmCreate, mempool_shmAttach or mempool_restore, every sector handle
+ * of it becomes invalid in this process. Pools from MEM_POOL_DECLARE are left untouched.
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_create
+ * Returns none.
+ ************************************************************************** */
+void mempool_destroy(const void *const pMem);
+
+/* **************************************************************************
+ * Function allocates a sector, waiting for one to be freed by another thread
+ * or process while the pool is exhausted. Sectors kept in a per thread cache
+ * do not end the wait until the cache spills them back to the pool.
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_init
+ *  Timeout     ->  Milliseconds to wait, negative waits forever
+ * Returns the Sector Pointer, NULL if none was freed in time or the pool is
+ * not MEM_POOL_FLAGS_CONCURRENT, no other thread could free one then
+ ************************************************************************** */
+void *mempool_allocWait(const void *const pMem, const long Timeout);
+
+/* **************************************************************************
+ * Function waits, consumer thread only, until the stream holds Count bytes.
+ * The producer wakes the consumer only if its pool is MEM_POOL_FLAGS_CONCURRENT.
+ *  pStream     ->  Pointer to the stream prepared by mempool_streamInit
+ *  Count       ->  Number of readable bytes wanted
+ *  Timeout     ->  Milliseconds to wait, negative waits forever
+ * Returns number of bytes mempool_streamRead can take, less than Count if
+ * the time ran out
+ ************************************************************************** */
+unsigned long mempool_streamWait(const t_MemStream *const pStream, const unsigned long Count, const long Timeout);
+
+/* **************************************************************************
+ * Function arms events of the pool on an eventfd for poll or epoll loops, the
+ * descriptor is opened on the first call. An armed event makes it readable
+ * once, read it and arm again before retrying the allocation or the read.
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_init
+ *  Events      ->  MEM_POOL_EVENT_FREE and MEM_POOL_EVENT_DATA to be armed
+ * Returns the eventfd, non blocking, -1 if it could not be opened or the pool
+ * is MEM_POOL_FLAGS_SHARED as a descriptor holds in one process only
+ ************************************************************************** */
+int mempool_eventFd(const void *const pMem, const unsigned long Events);
+
+/* **************************************************************************
+ * Function closes the eventfd of mempool_eventFd, pools released with
+ * mempool_destroy close it themselves. No other thread may allocate, free or
+ * write a stream on the pool meanwhile, one signalling the eventfd could
+ * write to a descriptor reopened under the same number.
+ *  pMem        ->  Pointer to the top of Heap memory returned by mempool_init
+ * Returns none.
+ ************************************************************************** */
+void mempool_eventClose(const void *const pMem);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif                  /* __MEM_POOL_H__ */
@@ -0,0 +1,271 @@
+/* ***************************************************************************************
+    MIT License
+
+    Copyright (c) 2026 Dhananjay Pilankar
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+ *************************************************************************************** */
+
+#ifndef __MEM_POOL_HPP__
+#define __MEM_POOL_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+#include "mempool.h"
+
+/* **************************************************************************
+ *              Classes
+ ************************************************************************** */
+namespace mempool {
+
+/* **************************************************************************
+ * Pool of SectCnt sectors of SectSize bytes laid out inside the object, the
+ * size MEM_POOL_DECLARE would reserve is worked out at compile time. The pool
+ * address is the handle of every sector, so the pool is neither copied nor
+ * moved.
+ *  SectCnt     ->  Number of sectors
+ *  SectSize    ->  Size of each memory sector
+ *  Flags       ->  MEM_POOL_FLAGS_CONCURRENT to share the pool among threads
+ ************************************************************************** */
+template<unsigned long SectCnt, unsigned long SectSize, unsigned long Flags = MEM_POOL_FLAGS_NONE>
+class MemPool {
+public:
+    static constexpr std::size_t Bytes = MEM_POOL_BYTES(SectCnt, SectSize);
+    static constexpr unsigned long SectorCount = SectCnt;
+    static constexpr unsigned long SectorSize = SectSize;
+
+    static_assert(SectCnt <= MEM_POOL_SECT_LIMIT, "sector index no longer fits a link");
+    static_assert(SectSize != 0, "sectors hold at least one byte");
+
+    MemPool() noexcept
+        : pMem_(mempool_initWithFlags(Mem_, (unsigned long)Bytes, SectCnt, SectSize, Flags))
+    {
+    }
+
+    MemPool(const MemPool &) = delete;
+    MemPool &operator=(const MemPool &) = delete;
+
+    // Pool handle for the C functions
+    void *get() const noexcept { return pMem_; }
+    unsigned long sectUsed() const noexcept { return mempool_sectUsed(pMem_); }
+    void stats(t_MemStats &Stats) const noexcept { mempool_stats(pMem_, &Stats); }
+
+private:
+    alignas(MEM_POOL_ALIGN) char Mem_[Bytes];
+    void *pMem_;
+};
+
+/* **************************************************************************
+ * Owner of an allocated sector chain, the chain goes back to its pool when
+ * the owner is destroyed. Ownership moves, data is shared only through clone.
+ ************************************************************************** */
+class MemChain {
+public:
+    MemChain() noexcept = default;
+
+    // Allocates the head sector, an empty chain if the pool is exhausted
+    explicit MemChain(const void *const pMem) noexcept
+        : pMem_(pMem), pSect_(mempool_alloc(pMem))
+    {
+    }
+
+    template<unsigned long SectCnt, unsigned long SectSize, unsigned long Flags>
+    explicit MemChain(const MemPool<SectCnt, SectSize, Flags> &Pool) noexcept
+        : MemChain(Pool.get())
+    {
+    }
+
+    MemChain(const MemChain &) = delete;
+    MemChain &operator=(const MemChain &) = delete;
+
+    MemChain(MemChain &&Other) noexcept
+        : pMem_(Other.pMem_), pSect_(std::exchange(Other.pSect_, nullptr))
+    {
+    }
+
+    MemChain &operator=(MemChain &&Other) noexcept
+    {
+        if(this != &Other)
+        {
+            reset(std::exchange(Other.pSect_, nullptr));
+            pMem_ = Other.pMem_;
+        }
+        return *this;
+    }
+
+    ~MemChain() { reset(); }
+
+    explicit operator bool() const noexcept { return pSect_ != nullptr; }
+
+    // Sector handle for the C functions, ownership stays
+    void *get() const noexcept { return pSect_; }
+
+    // Gives up ownership, the caller frees the chain
+    void *release() noexcept { return std::exchange(pSect_, nullptr); }
+
+    // Frees the chain held and takes pMemSect instead
+    void reset(void *const pMemSect = nullptr) noexcept
+    {
+        void *p_old = std::exchange(pSect_, pMemSect);
+
+        if(p_old != nullptr)
+        {
+            mempool_free(p_old);
+        }
+    }
+
+    unsigned long write(const void *const pSource, const unsigned long SrcSize) noexcept
+    {
+        return (pSect_ != nullptr) ? mempool_writeToIndex(pMem_, pSect_, (const char *)pSource, SrcSize) : 0uL;
+    }
+
+    unsigned long read(void *const pTarget, const unsigned long TargetSize) noexcept
+    {
+        return (pSect_ != nullptr) ? mempool_readFromIndex(pSect_, pTarget, TargetSize, TargetSize) : 0uL;
+    }
+
+    unsigned long available() const noexcept
+    {
+        return (pSect_ != nullptr) ? mempool_availableData(pSect_) : 0uL;
+    }
+
+    // Owner of a read only chain sharing this data, see mempool_clone
+    MemChain clone() const noexcept
+    {
+        MemChain copy;
+
+        copy.pMem_ = pMem_;
+        copy.pSect_ = (pSect_ != nullptr) ? mempool_clone(pSect_) : nullptr;
+        return copy;
+    }
+
+private:
+    const void *pMem_ = nullptr;
+    void *pSect_ = nullptr;
+};
+
+/* **************************************************************************
+ * Memory resource handing out whole pool sectors, requests larger than a
+ * sector or aligned beyond MEM_POOL_ALIGN go to the upstream resource, as do
+ * requests made while the pool is exhausted. The default upstream throws
+ * std::bad_alloc, so nothing reaches the global heap unless asked for.
+ ************************************************************************** */
+class MemResource : public std::pmr::memory_resource {
+public:
+    explicit MemResource(const void *const pMem,
+                            std::pmr::memory_resource *const pUpstream = std::pmr::null_memory_resource()) noexcept
+        : pPool_((const t_Mem *)pMem), pUpstream_(pUpstream)
+    {
+    }
+
+    template<unsigned long SectCnt, unsigned long SectSize, unsigned long Flags>
+    explicit MemResource(const MemPool<SectCnt, SectSize, Flags> &Pool,
+                            std::pmr::memory_resource *const pUpstream = std::pmr::null_memory_resource()) noexcept
+        : MemResource(Pool.get(), pUpstream)
+    {
+    }
+
+    std::pmr::memory_resource *upstream() const noexcept { return pUpstream_; }
+
+protected:
+    void *do_allocate(std::size_t Bytes, std::size_t Alignment) override
+    {
+        void *p_obj = nullptr;
+
+        if((Bytes <= pPool_->Sec_Size) && (Alignment <= MEM_POOL_ALIGN))
+        {
+            p_obj = mempool_objAlloc(pPool_);
+            if(p_obj != nullptr)
+            {
+                return p_obj;
+            }
+        }
+        return pUpstream_->allocate(Bytes, Alignment);
+    }
+
+    void do_deallocate(void *pBuffer, std::size_t Bytes, std::size_t Alignment) override
+    {
+        const uintptr_t data_start = (uintptr_t)pPool_ + pPool_->Mem_Start;
+
+        // Anything inside the sector area came from the pool
+        if(((uintptr_t)pBuffer >= data_start) && (((uintptr_t)pBuffer - data_start) < (pPool_->Sec_Max * pPool_->Sec_Stride)))
+        {
+            mempool_objFree(pPool_, pBuffer);
+            return;
+        }
+        pUpstream_->deallocate(pBuffer, Bytes, Alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &Other) const noexcept override
+    {
+        return this == &Other;
+    }
+
+private:
+    const t_Mem *pPool_;
+    std::pmr::memory_resource *pUpstream_;
+};
+
+/* **************************************************************************
+ * Allocator for standard containers drawing from a MemResource, containers
+ * of std::pmr take the resource itself instead
+ ************************************************************************** */
+template<class T>
+class MemAllocator {
+public:
+    using value_type = T;
+
+    explicit MemAllocator(MemResource &Resource) noexcept : pResource_(&Resource) {}
+
+    template<class U>
+    MemAllocator(const MemAllocator<U> &Other) noexcept : pResource_(Other.resource()) {}
+
+    T *allocate(const std::size_t Count)
+    {
+        if(Count > (SIZE_MAX / sizeof(T)))
+        {
+            throw std::bad_array_new_length();
+        }
+        return (T *)pResource_->allocate(Count * sizeof(T), alignof(T));
+    }
+
+    void deallocate(T *const pBuffer, const std::size_t Count) noexcept
+    {
+        pResource_->deallocate(pBuffer, Count * sizeof(T), alignof(T));
+    }
+
+    MemResource *resource() const noexcept { return pResource_; }
+
+    template<class U>
+    bool operator==(const MemAllocator<U> &Other) const noexcept { return pResource_ == Other.resource(); }
+
+    template<class U>
+    bool operator!=(const MemAllocator<U> &Other) const noexcept { return pResource_ != Other.resource(); }
+
+private:
+    MemResource *pResource_;
+};
+
+}                       /* namespace mempool */
+
+#endif                  /* __MEM_POOL_HPP__ */
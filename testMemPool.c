@@ -1,9 +1,24 @@
+#include <limits.h>
 #include <stdio.h>
 #include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
 #include "./memPool/mempool.h"
 
+#define TEST_THREADS                    16
+#define TEST_THREAD_LOOPS               100000
+#define TEST_THREAD_BATCH               4
+
 // MEM_POOL_DECLARE(Name_Of_Variable, Sector_Count, Buffer_Size_Of_Sector);
 MEM_POOL_DECLARE(test, 20, 32);
+MEM_POOL_DECLARE(shared, 48, 32);
+MEM_POOL_DECLARE(small, 16, 16);
+MEM_POOL_DECLARE(medium, 8, 64);
+MEM_POOL_DECLARE(large, 4, 256);
+MEM_POOL_DECLARE(stream, 256, 256);
 
 void *pMemory = NULL;
 
@@ -12,6 +27,11 @@ const char testAlphabetsLower[] = { "abcdefghijklmnopqrstuvwxyz" };
 const char testNumbers[] = { "1234567890" };
 char testRead[1024];
 
+void *pShared = NULL;
+unsigned long sharedOwner[48];
+unsigned long sharedTwice = 0;
+unsigned long sharedCached = 0;
+
 void memPoolOperations(void)
 {
     void *p_mem_pool_1 = NULL;
@@ -21,6 +41,11 @@ void memPoolOperations(void)
     
     pMemory = mempool_init(MEM_POOL_ADDR(test), MEM_POOL_SIZE(test), MEM_POOL_SECT_CNT(test), MEM_POOL_SECT_SIZE(test));
     printf("Memory Pool Initialized: %d with size: %d\r\n", pMemory, MEM_POOL_SIZE(test));
+    // Nothing is laid out when the memory or the link index cannot hold the pool
+    printf("Pool refused for short memory: %d, for too many sectors: %d, for empty sectors: %d\r\n",\
+            mempool_init(MEM_POOL_ADDR(small), MEM_POOL_SIZE(small), MEM_POOL_SECT_CNT(small) + 1, MEM_POOL_SECT_SIZE(small)) == NULL,\
+            mempool_init(MEM_POOL_ADDR(small), MEM_POOL_SIZE(small), MEM_POOL_SECT_LIMIT + 1, MEM_POOL_SECT_SIZE(small)) == NULL,\
+            mempool_init(MEM_POOL_ADDR(small), MEM_POOL_SIZE(small), MEM_POOL_SECT_CNT(small), 0) == NULL);
     p_mem_pool_1 = mempool_alloc(pMemory);
     printf("Memory Pool Allocated: %lu\r\n", (unsigned long)p_mem_pool_1);
 
@@ -74,10 +99,766 @@ void memPoolOperations(void)
     printf("Total Allocated Sectors after heap free again: %lu\r\n", mempool_sectUsed(pMemory));
 }
 
+void *memPoolWorker(void *pArg)
+{
+    unsigned long owner = (unsigned long)pArg;
+    unsigned long loop = 0;
+    unsigned long held = 0;
+    unsigned long index = 0;
+    void *p_sect[TEST_THREAD_BATCH];
+    t_MemCache cache;
+
+    mempool_cacheInit(&cache, pShared, 4, 2);
+    for(loop = 0; loop < TEST_THREAD_LOOPS; loop++)
+    {
+        for(held = 0; held < TEST_THREAD_BATCH; held++)
+        {
+            p_sect[held] = (sharedCached != 0) ? mempool_cacheAlloc(&cache) : mempool_alloc(pShared);
+            if(p_sect[held] == NULL)
+            {
+                break;
+            }
+            index = mempool_sectHandle(pShared, p_sect[held]) - 1uL;
+            if(__atomic_exchange_n(&sharedOwner[index], owner, __ATOMIC_RELAXED) != 0uL)
+            {
+                // Another thread holds the same sector
+                __atomic_add_fetch(&sharedTwice, 1uL, __ATOMIC_RELAXED);
+            }
+        }
+        while(held > 0)
+        {
+            held--;
+            index = mempool_sectHandle(pShared, p_sect[held]) - 1uL;
+            __atomic_store_n(&sharedOwner[index], 0uL, __ATOMIC_RELAXED);
+            if(sharedCached != 0)
+            {
+                mempool_cacheFree(&cache, p_sect[held]);
+            }
+            else
+            {
+                mempool_free(p_sect[held]);
+            }
+        }
+    }
+    mempool_cacheFlush(&cache);
+
+    return NULL;
+}
+
+void memPoolConcurrentOperations(void)
+{
+    pthread_t threads[TEST_THREADS];
+    unsigned long index = 0;
+
+    pShared = mempool_initWithFlags(MEM_POOL_ADDR(shared), MEM_POOL_SIZE(shared), MEM_POOL_SECT_CNT(shared),\
+                                    MEM_POOL_SECT_SIZE(shared), MEM_POOL_FLAGS_CONCURRENT);
+
+    for(sharedCached = 0; sharedCached < 2; sharedCached++)
+    {
+        for(index = 0; index < TEST_THREADS; index++)
+        {
+            pthread_create(&threads[index], NULL, memPoolWorker, (void *)(index + 1));
+        }
+        for(index = 0; index < TEST_THREADS; index++)
+        {
+            pthread_join(threads[index], NULL);
+        }
+
+        printf("Concurrent sectors handed out twice%s: %lu\r\n", (sharedCached != 0) ? " with caches" : "", sharedTwice);
+        printf("Concurrent Allocated Sectors after threads join: %lu\r\n", mempool_sectUsed(pShared));
+    }
+}
+
+void memPoolGroupOperations(void)
+{
+    t_MemGroup group;
+    void *p_pools[3];
+    void *p_mem_pool_1 = NULL;
+    unsigned long wrote = 0;
+    unsigned long index = 0;
+    char message[600];
+
+    p_pools[0] = mempool_init(MEM_POOL_ADDR(large), MEM_POOL_SIZE(large), MEM_POOL_SECT_CNT(large), MEM_POOL_SECT_SIZE(large));
+    p_pools[1] = mempool_init(MEM_POOL_ADDR(small), MEM_POOL_SIZE(small), MEM_POOL_SECT_CNT(small), MEM_POOL_SECT_SIZE(small));
+    p_pools[2] = mempool_init(MEM_POOL_ADDR(medium), MEM_POOL_SIZE(medium), MEM_POOL_SECT_CNT(medium), MEM_POOL_SECT_SIZE(medium));
+    mempool_groupInit(&group, p_pools, 3);
+
+    for(index = 0; index < sizeof(message); index++)
+    {
+        message[index] = testAlphabetsUpper[index % 26];
+    }
+
+    p_mem_pool_1 = mempool_groupAlloc(&group, 10);
+    wrote = mempool_groupWrite(&group, p_mem_pool_1, message, sizeof(message));
+    printf("Group Data Written: %lu, sectors small/medium/large: %lu/%lu/%lu\r\n", wrote, mempool_sectUsed(p_pools[1]),\
+                mempool_sectUsed(p_pools[2]), mempool_sectUsed(p_pools[0]));
+
+    memset(testRead, 0, sizeof(testRead));
+    printf("Group Data read matches: %d\r\n", (mempool_readFull(p_mem_pool_1, testRead, sizeof(testRead)) == sizeof(message)) &&\
+                (memcmp(testRead, message, sizeof(message)) == 0));
+
+    mempool_free(p_mem_pool_1);
+    printf("Group Allocated Sectors after free: %lu\r\n", mempool_sectUsed(p_pools[0]) + mempool_sectUsed(p_pools[1]) + mempool_sectUsed(p_pools[2]));
+}
+
+void memPoolIovecOperations(void)
+{
+    void *p_mem_pool_1 = NULL;
+    void *p_mem_pool_2 = NULL;
+    struct iovec iov[8];
+    unsigned long iov_cnt = 0;
+    long moved = 0;
+    int pipe_fd[2];
+
+    pMemory = mempool_init(MEM_POOL_ADDR(test), MEM_POOL_SIZE(test), MEM_POOL_SECT_CNT(test), MEM_POOL_SECT_SIZE(test));
+    p_mem_pool_1 = mempool_alloc(pMemory);
+    p_mem_pool_2 = mempool_alloc(pMemory);
+    mempool_writeToIndex(pMemory, p_mem_pool_1, testAlphabetsUpper, strlen((char *)testAlphabetsUpper));
+    mempool_writeToIndex(pMemory, p_mem_pool_1, testAlphabetsLower, strlen((char *)testAlphabetsLower));
+
+    if(pipe(pipe_fd) != 0)
+    {
+        return;
+    }
+
+    // Chain to pipe without a staging copy, first 10 bytes consumed before
+    mempool_readConsume(p_mem_pool_1, 10);
+    iov_cnt = mempool_readIovec(p_mem_pool_1, iov, 8);
+    moved = writev(pipe_fd[1], iov, (int)iov_cnt);
+    printf("Iovec segments sent: %lu, bytes: %ld, consumed: %lu\r\n", iov_cnt, moved, mempool_readConsume(p_mem_pool_1, (unsigned long)moved));
+
+    // Pipe straight into free space of another chain
+    iov_cnt = mempool_writeIovec(pMemory, p_mem_pool_2, iov, 8, 64);
+    moved = readv(pipe_fd[0], iov, (int)iov_cnt);
+    printf("Iovec segments received: %lu, bytes: %ld, committed: %lu\r\n", iov_cnt, moved, mempool_writeCommit(p_mem_pool_2, (unsigned long)moved));
+
+    memset(testRead, 0, sizeof(testRead));
+    mempool_readFromIndex(p_mem_pool_2, testRead, sizeof(testRead), mempool_availableData(p_mem_pool_2));
+    printf("Data read from Memory 2: %s\r\n", testRead);
+
+    close(pipe_fd[0]);
+    close(pipe_fd[1]);
+    mempool_free(p_mem_pool_1);
+    mempool_free(p_mem_pool_2);
+    printf("Total Allocated Sectors after iovec transfer: %lu\r\n", mempool_sectUsed(pMemory));
+}
+
+void memPoolReserveOperations(void)
+{
+    void *p_mem_pool_1 = NULL;
+    char *p_write = NULL;
+    unsigned long length = 0;
+    unsigned long index = 0;
+    int encoded = 0;
+
+    p_mem_pool_1 = mempool_alloc(pMemory);
+    for(index = 0; index < 4; index++)
+    {
+        // Encode straight into the sector, no staging buffer
+        p_write = (char *)mempool_writeReserve(pMemory, p_mem_pool_1, &length);
+        encoded = snprintf(p_write, length, "rec%lu;", index);
+        if((encoded > 0) && ((unsigned long)encoded < length))
+        {
+            mempool_writeCommit(p_mem_pool_1, (unsigned long)encoded);
+        }
+    }
+
+    memset(testRead, 0, sizeof(testRead));
+    mempool_readFull(p_mem_pool_1, testRead, sizeof(testRead));
+    printf("Data encoded in place: %s\r\n", testRead);
+    mempool_free(p_mem_pool_1);
+}
+
+#define TEST_STREAM_BYTES               1000000
+
+void *memPoolProducer(void *pArg)
+{
+    t_MemStream *p_stream = (t_MemStream *)pArg;
+    unsigned long sent = 0;
+    unsigned long chunk = 0;
+    unsigned long index = 0;
+    char block[97];
+
+    while(sent < TEST_STREAM_BYTES)
+    {
+        chunk = 1 + (sent % sizeof(block));
+        if(chunk > (TEST_STREAM_BYTES - sent))
+        {
+            chunk = TEST_STREAM_BYTES - sent;
+        }
+        for(index = 0; index < chunk; index++)
+        {
+            block[index] = (char)((sent + index) & 0xFF);
+        }
+        sent += mempool_streamWrite(p_stream, block, chunk);
+    }
+
+    return NULL;
+}
+
+void memPoolStreamOperations(void)
+{
+    t_MemStream stream;
+    t_MemStats stats;
+    pthread_t producer;
+    void *p_stream_pool = NULL;
+    unsigned long received = 0;
+    unsigned long mismatch = 0;
+    unsigned long read = 0;
+    unsigned long index = 0;
+    unsigned char block[61];
+
+    // Reclaim is refused unless producer and consumer may both use the free list
+    mempool_streamInit(&stream, pMemory, mempool_alloc(pMemory));
+    printf("Stream reclaim on a pool without MEM_POOL_FLAGS_CONCURRENT: %lu\r\n", mempool_streamReclaim(&stream, 1));
+    mempool_free(stream.pHead);
+
+    // Stream much larger than the pool, consumer returns what it has read
+    p_stream_pool = mempool_initWithFlags(MEM_POOL_ADDR(stream), MEM_POOL_SIZE(stream), MEM_POOL_SECT_CNT(stream),\
+                                            MEM_POOL_SECT_SIZE(stream), MEM_POOL_FLAGS_CONCURRENT);
+    mempool_streamInit(&stream, p_stream_pool, mempool_alloc(p_stream_pool));
+    mempool_streamReclaim(&stream, 1);
+    pthread_create(&producer, NULL, memPoolProducer, &stream);
+
+    while(received < TEST_STREAM_BYTES)
+    {
+        read = mempool_streamRead(&stream, block, sizeof(block));
+        for(index = 0; index < read; index++)
+        {
+            mismatch += (block[index] != (unsigned char)((received + index) & 0xFF)) ? 1 : 0;
+        }
+        received += read;
+    }
+    pthread_join(producer, NULL);
+
+    printf("Stream bytes received: %lu, mismatched: %lu\r\n", received, mismatch);
+    mempool_free(stream.pHead);
+    printf("Stream Allocated Sectors after free: %lu\r\n", mempool_sectUsed(p_stream_pool));
+
+    mempool_stats(p_stream_pool, &stats);
+    printf("Stream stats written: %lu, read: %lu, extended: %lu, most sectors held: %lu, failed: %lu\r\n",\
+            stats.Bytes_Written, stats.Bytes_Read, stats.Alloc_Extend, stats.Sect_High, stats.Alloc_Fail);
+}
+
+void *memPoolLateFree(void *pArg)
+{
+    usleep(50000);
+    mempool_free(pArg);
+
+    return NULL;
+}
+
+void *memPoolLateWrite(void *pArg)
+{
+    usleep(50000);
+    mempool_streamWrite((t_MemStream *)pArg, testAlphabetsLower, 20);
+    mempool_streamWrite((t_MemStream *)pArg, testAlphabetsUpper, 20);
+
+    return NULL;
+}
+
+void memPoolWaitOperations(void)
+{
+    t_MemStream stream;
+    pthread_t waker;
+    void *p_sect[48];
+    void *p_waited = NULL;
+    unsigned long index = 0;
+    unsigned long timed_out = 0;
+    unsigned long long events = 0;
+    int fd = -1;
+
+    for(index = 0; index < 48; index++)
+    {
+        p_sect[index] = mempool_alloc(pShared);
+    }
+    timed_out = (mempool_allocWait(pShared, 20) == NULL);
+
+    // Another thread frees a sector later, the wait takes it and the armed eventfd becomes readable
+    fd = mempool_eventFd(pShared, MEM_POOL_EVENT_FREE);
+    pthread_create(&waker, NULL, memPoolLateFree, p_sect[0]);
+    p_waited = mempool_allocWait(pShared, -1);
+    pthread_join(waker, NULL);
+    if(read(fd, &events, sizeof(events)) != (ssize_t)sizeof(events))
+    {
+        events = 0;
+    }
+    printf("Wait on exhausted pool timed out: %lu, woken by free: %d, eventfd signalled: %llu\r\n",\
+            timed_out, p_waited == p_sect[0], events);
+
+    for(index = 1; index < 48; index++)
+    {
+        mempool_free(p_sect[index]);
+    }
+
+    // 40 bytes arrive in two writes, the wait ends only after the second
+    mempool_streamInit(&stream, pShared, p_waited);
+    pthread_create(&waker, NULL, memPoolLateWrite, &stream);
+    printf("Stream wait for 40 bytes returned: %lu\r\n", mempool_streamWait(&stream, 40, 2000));
+    pthread_join(waker, NULL);
+    mempool_free(stream.pHead);
+    mempool_eventClose(pShared);
+    printf("Total Allocated Sectors after waits: %lu\r\n", mempool_sectUsed(pShared));
+}
+
+void memPoolReclaimOperations(void)
+{
+    void *p_mem_pool_1 = NULL;
+    unsigned long index = 0;
+    unsigned long most = 0;
+
+    p_mem_pool_1 = mempool_alloc(pMemory);
+    mempool_reclaimMode(p_mem_pool_1, 1);
+    for(index = 0; index < 100; index++)
+    {
+        mempool_writeToIndex(pMemory, p_mem_pool_1, testAlphabetsUpper, strlen((char *)testAlphabetsUpper));
+        mempool_readFromIndex(p_mem_pool_1, testRead, sizeof(testRead), 25);
+        if(mempool_sectUsed(pMemory) > most)
+        {
+            most = mempool_sectUsed(pMemory);
+        }
+    }
+    printf("Reclaim chain of %lu bytes written, unread: %lu, most sectors held: %lu\r\n", index * 26, mempool_availableData(p_mem_pool_1), most);
+
+    mempool_resetTrim(p_mem_pool_1);
+    printf("Total Allocated Sectors after trim: %lu\r\n", mempool_sectUsed(pMemory));
+    mempool_free(p_mem_pool_1);
+}
+
+void memPoolBulkOperations(void)
+{
+    void *p_sect[24];
+    t_MemStats before;
+    t_MemStats after;
+    unsigned long index = 0;
+    unsigned long length = 0;
+    unsigned long misaligned = 0;
+
+    // An empty request is no failed allocation
+    mempool_stats(pMemory, &before);
+    index = mempool_allocBulk(pMemory, p_sect, 0);
+    mempool_stats(pMemory, &after);
+    printf("Bulk allocation of 0 sectors: %lu, failures counted: %lu\r\n", index, after.Alloc_Fail - before.Alloc_Fail);
+    printf("Bulk allocation of 24 sectors: %lu\r\n", mempool_allocBulk(pMemory, p_sect, 24));
+    printf("Bulk allocation of 16 sectors: %lu\r\n", mempool_allocBulk(pMemory, p_sect, 16));
+    for(index = 0; index < 16; index++)
+    {
+        // Fresh sectors reserve from the start of their buffer
+        misaligned += (((uintptr_t)mempool_writeReserve(pMemory, p_sect[index], &length) & (MEM_POOL_ALIGN - 1)) != 0) ? 1 : 0;
+        mempool_writeToIndex(pMemory, p_sect[index], testNumbers, strlen((char *)testNumbers));
+    }
+    printf("Bulk sectors off MEM_POOL_ALIGN boundary: %lu\r\n", misaligned);
+    mempool_writeToIndex(pMemory, p_sect[0], testAlphabetsUpper, strlen((char *)testAlphabetsUpper));
+    printf("Total Allocated Sectors after bulk allocation: %lu\r\n", mempool_sectUsed(pMemory));
+    mempool_freeBulk(p_sect, 16);
+    printf("Total Allocated Sectors after bulk free: %lu\r\n", mempool_sectUsed(pMemory));
+}
+
+void memPoolObjectOperations(void)
+{
+    unsigned long *p_obj[20];
+    unsigned long index = 0;
+    unsigned long misaligned = 0;
+    unsigned long mismatched = 0;
+
+    for(index = 0; index < 20; index++)
+    {
+        p_obj[index] = (unsigned long *)mempool_objAlloc(pMemory);
+        misaligned += (((uintptr_t)p_obj[index] & (MEM_POOL_ALIGN - 1)) != 0) ? 1 : 0;
+        p_obj[index][0] = index;
+        p_obj[index][3] = ~index;
+    }
+    printf("Objects allocated: %lu, off MEM_POOL_ALIGN boundary: %lu, pool exhausted: %d\r\n",\
+            mempool_sectUsed(pMemory), misaligned, mempool_objAlloc(pMemory) == NULL);
+    for(index = 0; index < 20; index++)
+    {
+        mismatched += ((p_obj[index][0] != index) || (p_obj[index][3] != ~index)) ? 1 : 0;
+        mempool_objFree(pMemory, p_obj[index]);
+    }
+    // Freeing twice leaves the free list intact
+    mempool_objFree(pMemory, p_obj[0]);
+    printf("Objects mismatched: %lu, Total Allocated Sectors after object free: %lu\r\n", mismatched, mempool_sectUsed(pMemory));
+
+    // Pointers off a sector buffer of the pool are not freed
+    p_obj[0] = (unsigned long *)mempool_objAlloc(pMemory);
+    mempool_objFree(pMemory, testRead);
+    mempool_objFree(pMemory, (char *)p_obj[0] + MEM_POOL_ALIGN);
+    printf("Foreign and interior pointers ignored, sectors used: %lu\r\n", mempool_sectUsed(pMemory));
+    mempool_objFree(pMemory, p_obj[0]);
+
+    // Chain buffers are no objects, the chain keeps all its sectors
+    p_obj[0] = (unsigned long *)mempool_alloc(pMemory);
+    mempool_writeToIndex(pMemory, p_obj[0], testRead, 100);
+    index = mempool_sectUsed(pMemory);
+    mempool_objFree(pMemory, (char *)pMemory + ((t_Mem *)pMemory)->Mem_Start + (((t_Mem *)pMemory)->Sec_Stride * ((t_MemSect *)p_obj[0])->Self));
+    printf("Chain buffer freed as object ignored: %d, sectors used: %lu\r\n", mempool_sectUsed(pMemory) == index, index);
+    mempool_free(p_obj[0]);
+}
+
+void memPoolRecordOperations(void)
+{
+    void *p_sect = NULL;
+    const char *p_rec = NULL;
+    char scratch[64];
+    char source[64];
+    t_MemRecIter iter;
+    unsigned long index = 0;
+    unsigned long length = 0;
+    unsigned long records = 0;
+    unsigned long in_place = 0;
+    unsigned long mismatched = 0;
+
+    for(index = 0; index < sizeof(source); index++)
+    {
+        source[index] = testAlphabetsLower[index % 26];
+    }
+    p_sect = mempool_alloc(pMemory);
+    for(index = 0; index < 8; index++)
+    {
+        // Records of 3 to 45 bytes, some of them cross a 32 byte sector
+        mempool_recordWrite(pMemory, p_sect, source + (index % 4), 3 + (index * 6));
+    }
+    length = mempool_recordWrite(pMemory, p_sect, testRead, sizeof(testRead));
+    printf("Record too large for the pool stored: %lu, unread: %lu, sectors used: %lu\r\n",\
+            length, mempool_availableData(p_sect), mempool_sectUsed(pMemory));
+
+    mempool_recordIterInit(&iter, p_sect);
+    while((p_rec = (const char *)mempool_recordNext(&iter, scratch, sizeof(scratch), &length)) != NULL)
+    {
+        in_place += (p_rec != scratch) ? 1 : 0;
+        mismatched += ((length != (3 + (records * 6))) || (memcmp(p_rec, source + (records % 4), length) != 0)) ? 1 : 0;
+        records++;
+        if(records == 5)
+        {
+            mempool_recordConsume(p_sect, &iter);
+        }
+    }
+    printf("Records iterated: %lu, in place: %lu, mismatched: %lu, unread after consuming 5: %lu\r\n",\
+            records, in_place, mismatched, mempool_availableData(p_sect));
+
+    memset(testRead, 0, sizeof(testRead));
+    index = mempool_recordRead(p_sect, testRead, sizeof(testRead), &length);
+    printf("Record read: %lu %s, consumed: %lu\r\n", length, testRead, index);
+
+    // An empty record is consumed as well, only its prefix moves the read index
+    mempool_resetMemory(p_sect);
+    mempool_recordWrite(pMemory, p_sect, source, 0);
+    index = mempool_recordRead(p_sect, testRead, sizeof(testRead), &length);
+    printf("Empty record read: %lu, consumed: %lu, nothing left consumes: %lu\r\n", length, index,\
+            mempool_recordRead(p_sect, testRead, sizeof(testRead), &length));
+    mempool_free(p_sect);
+    printf("Total Allocated Sectors after records: %lu\r\n", mempool_sectUsed(pMemory));
+}
+
+void memPoolSpliceOperations(void)
+{
+    void *p_ingress = NULL;
+    void *p_egress = NULL;
+    char expect[160];
+    unsigned long index = 0;
+    unsigned long moved = 0;
+    unsigned long length = 0;
+    unsigned long used = 0;
+
+    for(index = 0; index < sizeof(expect); index++)
+    {
+        expect[index] = testAlphabetsLower[index % 26];
+    }
+    p_ingress = mempool_alloc(pMemory);
+    p_egress = mempool_alloc(pMemory);
+    // 100 bytes over four 32 byte sectors, 10 of them already read
+    mempool_writeToIndex(pMemory, p_ingress, expect, 100);
+    mempool_readFromIndex(p_ingress, testRead, sizeof(testRead), 10);
+    mempool_writeToIndex(pMemory, p_egress, testAlphabetsUpper, 20);
+    used = mempool_sectUsed(pMemory);
+
+    moved = mempool_splice(pMemory, p_egress, p_ingress);
+    printf("Spliced: %lu, egress unread: %lu, ingress unread: %lu, sectors used before: %lu after: %lu\r\n",\
+            moved, mempool_availableData(p_egress), mempool_availableData(p_ingress), used, mempool_sectUsed(pMemory));
+
+    // Writes go on after the moved data, the gap left in the egress sector is skipped by reads
+    mempool_writeToIndex(pMemory, p_egress, expect + 100, 30);
+    memset(testRead, 0, sizeof(testRead));
+    length = mempool_readFromIndex(p_egress, testRead, sizeof(testRead), sizeof(testRead));
+    printf("Egress read: %lu, mismatched: %d\r\n", length,\
+            (memcmp(testRead, testAlphabetsUpper, 20) != 0) || (memcmp(testRead + 20, expect + 10, 120) != 0));
+
+    mempool_resetMemory(p_egress);
+    mempool_writeToIndex(pMemory, p_egress, expect, 96);
+    memset(testRead, 0, sizeof(testRead));
+    length = mempool_readFull(p_egress, testRead, sizeof(testRead));
+    mempool_writeToIndex(pMemory, p_ingress, testAlphabetsUpper, 26);
+    printf("Rewritten after reset: %lu, mismatched: %d, ingress unread: %lu\r\n", length,\
+            memcmp(testRead, expect, 96) != 0, mempool_availableData(p_ingress));
+
+    mempool_free(p_ingress);
+    mempool_free(p_egress);
+    printf("Total Allocated Sectors after splice: %lu\r\n", mempool_sectUsed(pMemory));
+}
+
+void memPoolCloneOperations(void)
+{
+    void *p_source = NULL;
+    void *p_clone[3];
+    char expect[100];
+    unsigned long index = 0;
+    unsigned long length = 0;
+    unsigned long refused = 0;
+    unsigned long mismatched = 0;
+
+    for(index = 0; index < sizeof(expect); index++)
+    {
+        expect[index] = testAlphabetsLower[index % 26];
+    }
+    p_source = mempool_alloc(pMemory);
+    mempool_writeToIndex(pMemory, p_source, expect, sizeof(expect));
+    mempool_readFromIndex(p_source, testRead, sizeof(testRead), 5);
+
+    // Subscribers start at the read index of the source, the data is not copied
+    for(index = 0; index < 3; index++)
+    {
+        p_clone[index] = mempool_clone(p_source);
+    }
+    refused = (mempool_writeToIndex(pMemory, p_source, expect, 1) == 0) + (mempool_writeToIndex(pMemory, p_clone[0], expect, 1) == 0);
+    printf("Clones: 3, writes refused: %lu, sectors used: %lu\r\n", refused, mempool_sectUsed(pMemory));
+
+    // Source gone first, the clones keep the data alive
+    mempool_free(p_source);
+    printf("Sectors used after source freed: %lu\r\n", mempool_sectUsed(pMemory));
+    for(index = 0; index < 3; index++)
+    {
+        memset(testRead, 0, sizeof(testRead));
+        length = mempool_readFromIndex(p_clone[index], testRead, sizeof(testRead), sizeof(testRead));
+        mismatched += ((length != 95) || (memcmp(testRead, expect + 5, 95) != 0)) ? 1 : 0;
+        mempool_free(p_clone[index]);
+    }
+    printf("Clone reads mismatched: %lu, Total Allocated Sectors after clones: %lu\r\n", mismatched, mempool_sectUsed(pMemory));
+}
+
+void memPoolFindOperations(void)
+{
+    const char *lines[] = { "GET / HTTP/1.1", "Host: example", "", "body follows the blank line" };
+    void *p_mem_pool_1 = NULL;
+    unsigned long index = 0;
+    unsigned long offset = 0;
+    unsigned long missing = 0;
+    unsigned long mismatched = 0;
+
+    p_mem_pool_1 = mempool_alloc(pMemory);
+    for(index = 0; index < 3; index++)
+    {
+        mempool_writeToIndex(pMemory, p_mem_pool_1, lines[index], strlen(lines[index]));
+        mempool_writeToIndex(pMemory, p_mem_pool_1, "\r\n", 2);
+    }
+    mempool_writeToIndex(pMemory, p_mem_pool_1, lines[3], strlen(lines[3]));
+
+    // Header ends with an empty line, its four bytes cross from the first sector into the second
+    offset = mempool_findPattern(p_mem_pool_1, "\r\n\r\n", 4);
+    printf("Header end found at: %lu, sectors used: %lu\r\n", offset, mempool_sectUsed(pMemory));
+
+    // Each line read up to its delimiter, straight from the offset found
+    for(index = 0; index < 4; index++)
+    {
+        offset = mempool_find(p_mem_pool_1, '\n');
+        if(offset == MEM_POOL_NOT_FOUND)
+        {
+            // Last line is not terminated
+            offset = mempool_availableData(p_mem_pool_1);
+            missing++;
+        }
+        else
+        {
+            offset++;
+        }
+        memset(testRead, 0, sizeof(testRead));
+        mempool_readFromIndex(p_mem_pool_1, testRead, sizeof(testRead), offset);
+        mismatched += (strncmp(testRead, lines[index], strlen(lines[index])) != 0) ? 1 : 0;
+    }
+    printf("Lines read: %lu, mismatched: %lu, without delimiter: %lu\r\n", index, mismatched, missing);
+    mempool_free(p_mem_pool_1);
+}
+
+void memPoolMappedOperations(void)
+{
+    void *p_mapped = NULL;
+    void *p_mem_pool_1 = NULL;
+    unsigned long index = 0;
+    unsigned long written = 0;
+    unsigned long mismatch = 0;
+
+    // Sizes from a configuration are checked before anything is mapped
+    printf("Mapped pool refused for wrapping size: %d, for sectors over 32 bits: %d\r\n",\
+            mempool_create(MEM_POOL_SECT_LIMIT, ULONG_MAX / 1024uL, MEM_POOL_FLAGS_NONE) == NULL,\
+            mempool_create(1, (unsigned long)UINT32_MAX + 1uL, MEM_POOL_FLAGS_NONE) == NULL);
+
+    // Pool sized at run time, 4 MiB of 4 KiB sectors faulted in up front
+    p_mapped = mempool_create(1024, 4096, MEM_POOL_FLAGS_HUGEPAGE | MEM_POOL_FLAGS_POPULATE);
+    if(p_mapped == NULL)
+    {
+        printf("Mapped pool could not be created\r\n");
+        return;
+    }
+
+    p_mem_pool_1 = mempool_alloc(p_mapped);
+    for(index = 0; index < 10000; index++)
+    {
+        written += mempool_writeToIndex(p_mapped, p_mem_pool_1, testAlphabetsLower, strlen((char *)testAlphabetsLower));
+    }
+    for(index = 0; index < written; index += 26)
+    {
+        mempool_readFromIndex(p_mem_pool_1, testRead, sizeof(testRead), 26);
+        mismatch += (memcmp(testRead, testAlphabetsLower, 26) != 0) ? 1 : 0;
+    }
+    printf("Mapped pool written: %lu, sectors: %lu, mismatched: %lu\r\n", written, mempool_sectUsed(p_mapped), mismatch);
+    mempool_free(p_mem_pool_1);
+    mempool_destroy(p_mapped);
+}
+
+void memPoolGrowableOperations(void)
+{
+    void *p_growable = NULL;
+    void *p_mem_pool_1 = NULL;
+    unsigned long index = 0;
+    unsigned long written = 0;
+
+    // Starts with 16 sectors, a burst grows it 64 at a time up to 4096
+    p_growable = mempool_createGrowable(16, 4096, 64, 128, MEM_POOL_FLAGS_NONE);
+    if(p_growable == NULL)
+    {
+        printf("Growable pool could not be created\r\n");
+        return;
+    }
+
+    p_mem_pool_1 = mempool_alloc(p_growable);
+    for(index = 0; index < 2000; index++)
+    {
+        written += mempool_writeToIndex(p_growable, p_mem_pool_1, testAlphabetsUpper, strlen((char *)testAlphabetsUpper));
+    }
+    printf("Growable pool written: %lu, sectors used: %lu\r\n", written, mempool_sectUsed(p_growable));
+
+    mempool_free(p_mem_pool_1);
+    p_mem_pool_1 = mempool_alloc(p_growable);
+    printf("Growable pool sectors released when idle: %lu\r\n", mempool_shrink(p_growable));
+    mempool_writeToIndex(p_growable, p_mem_pool_1, testNumbers, strlen((char *)testNumbers));
+    memset(testRead, 0, sizeof(testRead));
+    mempool_readFull(p_mem_pool_1, testRead, sizeof(testRead));
+    printf("Data read from Growable pool: %s\r\n", testRead);
+    mempool_free(p_mem_pool_1);
+    mempool_destroy(p_growable);
+}
+
+void memPoolSharedOperations(void)
+{
+    void *p_owner = NULL;
+    void *p_peer = NULL;
+    void *p_sect = NULL;
+    unsigned long handle = 0;
+    unsigned long read = 0;
+    int status = 0;
+    int fd = -1;
+    pid_t child = 0;
+
+    fd = shm_open("/memPoolTest", O_CREAT | O_EXCL | O_RDWR, 0600);
+    shm_unlink("/memPoolTest");
+    p_owner = mempool_shmCreate(fd, 32, 64, MEM_POOL_FLAGS_NONE);
+    if(p_owner == NULL)
+    {
+        printf("Shared pool not available\r\n");
+        return;
+    }
+
+    // Chain written through one mapping, read through another at a different address
+    p_peer = mempool_shmAttach(fd);
+    p_sect = mempool_alloc(p_owner);
+    mempool_writeToIndex(p_owner, p_sect, testAlphabetsUpper, strlen((char *)testAlphabetsUpper));
+    mempool_writeToIndex(p_owner, p_sect, testAlphabetsLower, strlen((char *)testAlphabetsLower));
+    mempool_writeToIndex(p_owner, p_sect, testAlphabetsUpper, strlen((char *)testAlphabetsUpper));
+    handle = mempool_sectHandle(p_owner, p_sect);
+    memset(testRead, 0, sizeof(testRead));
+    read = mempool_readFromIndex(mempool_handleSect(p_peer, handle), testRead, sizeof(testRead), 52);
+    printf("Shared pool mapped twice: %d, read through second mapping: %lu %s\r\n", p_owner != p_peer, read, testRead);
+    mempool_free(mempool_handleSect(p_peer, handle));
+
+    // Child process maps the pool on its own and hands a chain back
+    child = fork();
+    if(child == 0)
+    {
+        p_peer = mempool_shmAttach(fd);
+        p_sect = mempool_alloc(p_peer);
+        mempool_writeToIndex(p_peer, p_sect, testNumbers, strlen((char *)testNumbers));
+        _exit((int)mempool_sectHandle(p_peer, p_sect));
+    }
+    waitpid(child, &status, 0);
+    memset(testRead, 0, sizeof(testRead));
+    p_sect = mempool_handleSect(p_owner, (unsigned long)WEXITSTATUS(status));
+    read = mempool_readFull(p_sect, testRead, sizeof(testRead));
+    printf("Shared pool chain from child process: %lu %s\r\n", read, testRead);
+    mempool_free(p_sect);
+    printf("Shared pool Allocated Sectors after free: %lu\r\n", mempool_sectUsed(p_peer));
+
+    mempool_destroy(p_peer);
+    mempool_destroy(p_owner);
+    close(fd);
+}
+
+void memPoolSnapshotOperations(void)
+{
+    void *p_restored = NULL;
+    void *p_sect = NULL;
+    unsigned long handle = 0;
+    unsigned long written = 0;
+    unsigned long read = 0;
+    char flip = 0;
+    FILE *p_file = NULL;
+
+    p_sect = mempool_alloc(pMemory);
+    mempool_writeToIndex(pMemory, p_sect, testAlphabetsLower, strlen((char *)testAlphabetsLower));
+    mempool_writeToIndex(pMemory, p_sect, testNumbers, strlen((char *)testNumbers));
+    mempool_readFromIndex(p_sect, testRead, sizeof(testRead), 20);
+    handle = mempool_sectHandle(pMemory, p_sect);
+    written = mempool_snapshot(pMemory, "/tmp/memPoolTest.snap");
+    mempool_free(p_sect);
+
+    // Chain comes back with its read index where the snapshot left it
+    p_restored = mempool_restore("/tmp/memPoolTest.snap");
+    memset(testRead, 0, sizeof(testRead));
+    read = mempool_readFromIndex(mempool_handleSect(p_restored, handle), testRead, sizeof(testRead), 64);
+    printf("Snapshot written: %d, restored sectors used: %lu, data: %lu %s\r\n",\
+            written != 0, mempool_sectUsed(p_restored), read, testRead);
+    mempool_destroy(p_restored);
+
+    // Damaged metadata is refused
+    p_file = fopen("/tmp/memPoolTest.snap", "r+b");
+    fseek(p_file, (long)sizeof(t_Mem), SEEK_SET);
+    flip = (char)(fgetc(p_file) ^ 0x5A);
+    fseek(p_file, (long)sizeof(t_Mem), SEEK_SET);
+    fputc(flip, p_file);
+    fclose(p_file);
+    printf("Snapshot with damaged metadata restored: %d\r\n", mempool_restore("/tmp/memPoolTest.snap") != NULL);
+    unlink("/tmp/memPoolTest.snap");
+}
+
 int main(void)
 {
     printf("Memory Allocator Test Begins\r\n******************************\r\n");
     memPoolOperations();
+    memPoolConcurrentOperations();
+    memPoolGroupOperations();
+    memPoolIovecOperations();
+    memPoolReserveOperations();
+    memPoolReclaimOperations();
+    memPoolBulkOperations();
+    memPoolObjectOperations();
+    memPoolRecordOperations();
+    memPoolSpliceOperations();
+    memPoolCloneOperations();
+    memPoolFindOperations();
+    memPoolStreamOperations();
+    memPoolWaitOperations();
+    memPoolMappedOperations();
+    memPoolGrowableOperations();
+    memPoolSharedOperations();
+    memPoolSnapshotOperations();
     printf("\r\n******************************\r\nMemory Allocator Test Ends");
     return 0;
 }
@@ -87,6 +868,6 @@ int main(void)
 /* 
  * Build syntax
  * 
- * gcc -O0 -I./memPool -g memPool/mempool.c testMemPool.c -o testMemPool
+ * gcc -O0 -I./memPool -g memPool/mempool.c testMemPool.c -o testMemPool -pthread
  * 
  * */
@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <string.h>
+#include <list>
+#include <memory_resource>
+#include <new>
+#include <unordered_map>
+#include <vector>
+#include "./memPool/mempool.hpp"
+
+const char testAlphabetsUpper[] = { "ABCDEFGHIJKLMNOPQRSTUVWXYZ" };
+char testRead[1024];
+
+mempool::MemPool<32, 64> testPool;
+mempool::MemPool<64, 256> containerPool;
+
+void memPoolChainOperations(void)
+{
+    unsigned long wrote = 0;
+    unsigned long read = 0;
+
+    static_assert(sizeof(testPool) >= MEM_POOL_BYTES(32, 64), "pool storage too small");
+    {
+        mempool::MemChain chain_1(testPool);
+        mempool::MemChain chain_2;
+
+        wrote = chain_1.write(testAlphabetsUpper, strlen(testAlphabetsUpper));
+        wrote += chain_1.write(testAlphabetsUpper, strlen(testAlphabetsUpper));
+        wrote += chain_1.write(testAlphabetsUpper, strlen(testAlphabetsUpper));
+        printf("Chain Data Written: %lu, sectors used: %lu\r\n", wrote, testPool.sectUsed());
+
+        // Ownership moves, the moved from chain is empty
+        chain_2 = std::move(chain_1);
+        printf("Chain moved, source empty: %d, available: %lu\r\n", !chain_1, chain_2.available());
+
+        memset(testRead, 0, sizeof(testRead));
+        read = chain_2.read(testRead, 26);
+        printf("Chain Data Read: %lu %s\r\n", read, testRead);
+
+        // Clone reads the same sectors from the read index on
+        mempool::MemChain chain_3 = chain_2.clone();
+        memset(testRead, 0, sizeof(testRead));
+        read = chain_3.read(testRead, 26);
+        printf("Chain Clone Read: %lu %s, source available: %lu\r\n", read, testRead, chain_2.available());
+    }
+    printf("Chain sectors used after scope: %lu\r\n", testPool.sectUsed());
+}
+
+void memPoolResourceOperations(void)
+{
+    mempool::MemResource resource(containerPool);
+    unsigned long index = 0;
+    unsigned long sum = 0;
+    int refused = 0;
+
+    {
+        std::pmr::vector<unsigned long> values(&resource);
+        std::pmr::unordered_map<unsigned long, unsigned long> lookup(8, &resource);
+
+        values.reserve(16);
+        for(index = 0; index < 16; index++)
+        {
+            values.push_back(index);
+            lookup[index] = index * index;
+        }
+        for(index = 0; index < 16; index++)
+        {
+            sum += values[index] + lookup[index];
+        }
+        printf("Resource vector and map sum: %lu, sectors used: %lu\r\n", sum, containerPool.sectUsed());
+
+        try
+        {
+            // Larger than a sector and no upstream to fall back to
+            values.reserve(1024);
+        }
+        catch(const std::bad_alloc &)
+        {
+            refused = 1;
+        }
+        printf("Resource refused oversized request: %d\r\n", refused);
+    }
+    printf("Resource sectors used after scope: %lu\r\n", containerPool.sectUsed());
+
+    {
+        mempool::MemAllocator<unsigned long> allocator(resource);
+        std::list<unsigned long, mempool::MemAllocator<unsigned long>> nodes(allocator);
+
+        for(index = 0; index < 10; index++)
+        {
+            nodes.push_back(index);
+        }
+        printf("Allocator list nodes: %lu, sectors used: %lu\r\n", (unsigned long)nodes.size(), containerPool.sectUsed());
+    }
+    printf("Allocator sectors used after scope: %lu\r\n", containerPool.sectUsed());
+}
+
+int main(void)
+{
+    printf("Memory Allocator C++ Test Begins\r\n******************************\r\n");
+    memPoolChainOperations();
+    memPoolResourceOperations();
+    printf("\r\n******************************\r\nMemory Allocator C++ Test Ends");
+    return 0;
+}
+
+/* End of Code */
+
+/* 
+ * Build syntax
+ * 
+ * gcc -c -O0 -I./memPool -g memPool/mempool.c -o mempool.o
+ * g++ -std=c++17 -O0 -I./memPool -g testMemPool.cpp mempool.o -o testMemPoolCpp -pthread
+ * 
+ * */